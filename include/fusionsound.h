@@ -188,10 +188,48 @@ typedef enum {
      FSSDF_SAMPLERATE                      = 0x00000008,         /* Sample rate is set. */
      FSSDF_PREBUFFER                       = 0x00000010,         /* Prebuffer amount is set. */
      FSSDF_CHANNELMODE                     = 0x00000020,         /* Channel mode is set. */
+     FSSDF_CAPS                            = 0x00000040,         /* Stream capabilities are set. */
 
-     FSSDF_ALL                             = 0x0000003F          /* All of these. */
+     FSSDF_ALL                             = 0x0000007F          /* All of these. */
 } FSStreamDescriptionFlags;
 
+/*
+ * Capabilities of a stream.
+ */
+typedef enum {
+     FSSCAPS_NONE                          = 0x00000000,         /* None of these. */
+
+     FSSCAPS_RING                          = 0x00000001,         /* Written frames are handed to the mixer through
+                                                                    read and write indices of the ring buffer, without
+                                                                    locking the playback for each write. The playback
+                                                                    keeps running while the ring buffer is empty, so
+                                                                    the prebuffer amount only applies to the start. */
+     FSSCAPS_CALLBACK                      = 0x00000002,         /* The ring buffer is filled by the callback given in
+                                                                    the description, just in time for each mixing
+                                                                    cycle, instead of Write() or Access(). Implies
+                                                                    FSSCAPS_RING. */
+
+     FSSCAPS_ALL                           = 0x00000003          /* All of these. */
+} FSStreamCapabilities;
+
+/*
+ * Called to fill the ring buffer of a stream with FSSCAPS_CALLBACK.
+ *
+ * The callback writes up to 'length' samples per channel to
+ * 'data' and returns the number of samples written. Samples
+ * not written are played as silence, the playback keeps
+ * running and the callback is called again for the next
+ * mixing cycle, returning zero is fine if no samples are
+ * available (yet). It's called while mixing, without a
+ * timeout, and must not block, otherwise the output of all
+ * playbacks is delayed until it returns.
+ */
+typedef int (*FSStreamCallback) (
+     void                                   *data,
+     int                                     length,
+     void                                   *ctx
+);
+
 /*
  * Encodes sample format constants in the following way (bit 31 - 0):
  *
@@ -355,8 +393,79 @@ typedef struct {
      int                                     prebuffer;          /* Samples to buffer before starting the playback.
                                                                     A negative value disables auto start of playback. */
      FSChannelMode                           channelmode;        /* Channel mode (overrides channels). */
+     FSStreamCapabilities                    caps;               /* Stream capabilities. */
+     FSStreamCallback                        callback;           /* Fill callback for FSSCAPS_CALLBACK. */
+     void                                   *callback_ctx;       /* Context of the fill callback. */
 } FSStreamDescription;
 
+/*
+ * Fragment of sample data written to a stream, see IFusionSoundStream::Writev().
+ */
+typedef struct {
+     const void                             *data;               /* Sample data. */
+     int                                     length;             /* Number of samples per channel. */
+} FSStreamFragment;
+
+/*
+ * Flags for simple playback.
+ */
+typedef enum {
+     FSPLAY_NOFX                           = 0x00000000,         /* No effects are applied. */
+
+     FSPLAY_LOOPING                        = 0x00000001,         /* Playback will continue at the beginning of the
+                                                                    buffer as soon as the end is reached. There's no gap
+                                                                    produced by concatenation. Only one looping playback
+                                                                    at a time is supported by the simple playback. */
+     FSPLAY_CYCLE                          = 0x00000002,         /* Play the whole buffer for one cycle, wrapping at the
+                                                                    end. */
+     FSPLAY_REWIND                         = 0x00000004,         /* Play reversing sample order. */
+
+     FSPLAY_ALL                            = 0x00000007          /* All of these. */
+} FSBufferPlayFlags;
+
+/*
+ * Playback started or stopped as part of a batch.
+ *
+ * Either 'playback' or 'buffer' is set. A playback is started
+ * like IFusionSoundPlayback::Start() using 'start' and 'stop',
+ * a buffer like IFusionSoundBuffer::Play() using 'flags'.
+ * Stopping a buffer stops its looping playback.
+ */
+typedef struct {
+     IFusionSoundPlayback                   *playback;           /* Playback to start or stop. */
+     IFusionSoundBuffer                     *buffer;             /* Buffer to play or stop. */
+
+     int                                     start;              /* Start position of the playback. */
+     int                                     stop;               /* Stop position of the playback. */
+     FSBufferPlayFlags                       flags;              /* Flags for playing the buffer. */
+} FSBatchEntry;
+
+/*
+ * Flags for playback parameter updates.
+ */
+typedef enum {
+     FSPUF_NONE                            = 0x00000000,         /* None of these. */
+
+     FSPUF_VOLUME                          = 0x00000001,         /* Volume is set. */
+     FSPUF_PAN                             = 0x00000002,         /* Panning is set. */
+     FSPUF_PITCH                           = 0x00000004,         /* Pitch is set. */
+
+     FSPUF_ALL                             = 0x00000007          /* All of these. */
+} FSPlaybackUpdateFlags;
+
+/*
+ * Parameter update of a playback, see IFusionSoundPlayback::SetVolume(), SetPan() and SetPitch().
+ */
+typedef struct {
+     IFusionSoundPlayback                   *playback;           /* Playback to update. */
+
+     FSPlaybackUpdateFlags                   flags;              /* Parameters to set. */
+
+     float                                   volume;             /* Volume level. */
+     float                                   pan;                /* Panning value. */
+     float                                   pitch;              /* Pitch value. */
+} FSPlaybackUpdate;
+
 /*
  * IFusionSound is the main interface. It can be retrieved by a
  * call to FusionSoundCreate().
@@ -494,29 +603,48 @@ D_DEFINE_INTERFACE( IFusionSound,
           float                             *ret_left,
           float                             *ret_right
      );
+
+   /** Batches **/
+
+     /*
+      * Start a number of playbacks and buffers at once.
+      *
+      * All of them begin on the same sample. If one of them
+      * can't be started, none is started.
+      */
+     DirectResult (*StartBatch) (
+          IFusionSound                      *thiz,
+          const FSBatchEntry                *entries,
+          int                                num
+     );
+
+     /*
+      * Stop a number of playbacks and buffers at once.
+      */
+     DirectResult (*StopBatch) (
+          IFusionSound                      *thiz,
+          const FSBatchEntry                *entries,
+          int                                num
+     );
+
+     /*
+      * Update parameters of a number of playbacks.
+      *
+      * Each playback is updated at once instead of once per
+      * parameter. Updates are applied in order, stopping at
+      * the first invalid one.
+      */
+     DirectResult (*UpdatePlaybacks) (
+          IFusionSound                      *thiz,
+          const FSPlaybackUpdate            *updates,
+          int                                num
+     );
 )
 
 /**********************
  * IFusionSoundBuffer *
  **********************/
 
-/*
- * Flags for simple playback.
- */
-typedef enum {
-     FSPLAY_NOFX                           = 0x00000000,         /* No effects are applied. */
-
-     FSPLAY_LOOPING                        = 0x00000001,         /* Playback will continue at the beginning of the
-                                                                    buffer as soon as the end is reached. There's no gap
-                                                                    produced by concatenation. Only one looping playback
-                                                                    at a time is supported by the simple playback. */
-     FSPLAY_CYCLE                          = 0x00000002,         /* Play the whole buffer for one cycle, wrapping at the
-                                                                    end. */
-     FSPLAY_REWIND                         = 0x00000004,         /* Play reversing sample order. */
-
-     FSPLAY_ALL                            = 0x00000007          /* All of these. */
-} FSBufferPlayFlags;
-
 /*
  * IFusionSoundBuffer represents a static block of sample data.
  *
@@ -679,7 +807,8 @@ D_DEFINE_INTERFACE( IFusionSoundStream,
       * This method blocks until there's free space of at least
       * the specified length (number of samples per channel).
       * Specifying a length of zero waits until playback has
-      * finished.
+      * finished, for streams with FSSCAPS_RING until all written
+      * samples have been played.
       */
      DirectResult (*Wait) (
           IFusionSoundStream                *thiz,
@@ -762,6 +891,8 @@ D_DEFINE_INTERFACE( IFusionSoundStream,
       *
       * This method returns a pointer to the current write
       * position and the amount of available space in frames.
+      * The space is contiguous, even if it wraps around the end
+      * of the ring buffer.
       * If the ring buffer is full, the method blocks until
       * there is space available.
       * After filling the ring buffer, call Commit() to submit
@@ -780,6 +911,70 @@ D_DEFINE_INTERFACE( IFusionSoundStream,
           IFusionSoundStream                *thiz,
           int                                length
      );
+
+   /** Event handling **/
+
+     /*
+      * Create a file descriptor for waiting on the stream.
+      *
+      * The descriptor is readable as long as Wait() with the
+      * specified length would return immediately, i.e. while
+      * there's free space of at least the specified length or,
+      * for a length of zero, while the stream isn't playing
+      * (or has played all samples, see Wait()).
+      * It can be used with select(), poll() or epoll instead of
+      * blocking in Wait(). The descriptor is owned by the
+      * stream, calling this method again changes the length.
+      * It must not be read from or closed by the application.
+      */
+     DirectResult (*CreateFileDescriptor) (
+          IFusionSoundStream                *thiz,
+          int                                length,
+          int                               *ret_fd
+     );
+
+   /** Non-blocking writing **/
+
+     /*
+      * Write as much of the sample data as fits into the ring
+      * buffer without blocking.
+      *
+      * The length specifies the number of samples per channel,
+      * the number of samples written is returned, which may be
+      * zero if the ring buffer is full. The descriptor from
+      * CreateFileDescriptor() can be used to wait for space.
+      *
+      * Only supported by streams created with FSSCAPS_RING
+      * (but not FSSCAPS_CALLBACK), which hand written samples
+      * to the mixer without waiting for the playback.
+      *
+      * The write that fills the stream up to the prebuffer
+      * amount of a stopped stream also starts the playback,
+      * which may block briefly while the playback is added
+      * to the mixer. Subsequent writes don't block.
+      */
+     DirectResult (*TryWrite) (
+          IFusionSoundStream                *thiz,
+          const void                        *sample_data,
+          int                                length,
+          int                               *ret_written
+     );
+
+   /** Writing fragments **/
+
+     /*
+      * Write sample data held in several fragments into the ring
+      * buffer.
+      *
+      * This is equivalent to calling Write() for each fragment
+      * in turn, but the playback is updated only once for all
+      * fragments fitting into the ring buffer.
+      */
+     DirectResult (*Writev) (
+          IFusionSoundStream                *thiz,
+          const FSStreamFragment            *fragments,
+          int                                num
+     );
 )
 
 /************************
@@ -794,6 +989,19 @@ typedef enum {
      FSPD_BACKWARD                         = -1,                 /* Backward. */
 } FSPlaybackDirection;
 
+/*
+ * Interpolation quality used when resampling a playback.
+ */
+typedef enum {
+     FSPQ_NONE                             = 0x00000000,         /* Nearest sample. */
+     FSPQ_LINEAR                           = 0x00000001,         /* Linear interpolation between two samples. */
+     FSPQ_CUBIC                            = 0x00000002,         /* Cubic Hermite interpolation of four samples. */
+     FSPQ_SINC                             = 0x00000003          /* Windowed-sinc interpolation of sixteen samples. */
+} FSPlaybackQuality;
+
+/* Number of playback qualities defined. */
+#define FS_NUM_PLAYBACK_QUALITIES            4
+
 /*
  * IFusionSoundPlayback represents one concurrent playback and
  * provides full control over the internal processing of samples.
@@ -810,8 +1018,8 @@ typedef enum {
  * Information provided by GetStatus() includes the current
  * position and whether the playback is running.
  *
- * Parameters provide live control over volume, pan, pitch and
- * direction of the playback.
+ * Parameters provide live control over volume, pan, pitch,
+ * direction and interpolation quality of the playback.
  */
 D_DEFINE_INTERFACE( IFusionSoundPlayback,
 
@@ -946,6 +1154,54 @@ D_DEFINE_INTERFACE( IFusionSoundPlayback,
           float                              center,
           float                              rear
      );
+
+     /*
+      * Set the interpolation quality.
+      *
+      * The quality is used whenever the samples are resampled,
+      * i.e. if the pitch is not 1.0f or the sample rate differs
+      * from the output. Higher qualities take more CPU time.
+      * The default quality is set by the 'quality' option.
+      */
+     DirectResult (*SetQuality) (
+          IFusionSoundPlayback              *thiz,
+          FSPlaybackQuality                  quality
+     );
+
+   /** Event handling **/
+
+     /*
+      * Create a file descriptor for waiting on the playback.
+      *
+      * The descriptor is readable as long as the playback isn't
+      * running, i.e. when Wait() would return immediately.
+      * It can be used with select(), poll() or epoll instead of
+      * blocking in Wait(). The descriptor is owned by the
+      * playback interface and must not be read from or closed
+      * by the application.
+      */
+     DirectResult (*CreateFileDescriptor) (
+          IFusionSoundPlayback              *thiz,
+          int                               *ret_fd
+     );
+
+     /*
+      * Create a file descriptor for waiting on the playback to
+      * advance.
+      *
+      * The descriptor becomes readable once the specified number
+      * of samples (per channel) has been played from now on, or
+      * when the playback isn't running. It's the descriptor from
+      * CreateFileDescriptor(), which is changed to wait for the
+      * new condition, until either method is called again.
+      * Not supported by the playback of a stream, see the
+      * CreateFileDescriptor() method of IFusionSoundStream.
+      */
+     DirectResult (*CreateAdvanceDescriptor) (
+          IFusionSoundPlayback              *thiz,
+          int                                length,
+          int                               *ret_fd
+     );
 )
 
 /*****************************
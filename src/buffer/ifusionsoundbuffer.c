@@ -25,6 +25,9 @@ D_DEBUG_DOMAIN( Buffer, "IFusionSoundBuffer", "IFusionSoundBuffer Interface" );
 
 /**********************************************************************************************************************/
 
+/* Maximum number of playback objects kept for reuse by non-looping playbacks. */
+#define MAX_RECYCLED_PLAYBACKS 16
+
 /*
  * private data struct of IFusionSoundBuffer
  */
@@ -44,6 +47,9 @@ typedef struct {
 
      CorePlayback    *looping_playback;
 
+     CorePlayback    *playbacks[MAX_RECYCLED_PLAYBACKS]; /* non-looping playbacks, reused once finished */
+     int              num_playbacks;
+
      DirectMutex      lock;
 } IFusionSoundBuffer_data;
 
@@ -53,6 +59,7 @@ static void
 IFusionSoundBuffer_Destruct( IFusionSoundBuffer *thiz )
 {
      IFusionSoundBuffer_data *data = thiz->priv;
+     int                      i;
 
      D_DEBUG_AT( Buffer, "%s( %p )\n", __FUNCTION__, thiz );
 
@@ -65,6 +72,10 @@ IFusionSoundBuffer_Destruct( IFusionSoundBuffer *thiz )
           fs_playback_unref( data->looping_playback );
      }
 
+     /* Discard non-looping playbacks, running ones are destroyed when they have finished. */
+     for (i = 0; i < data->num_playbacks; i++)
+          fs_playback_unref( data->playbacks[i] );
+
      fs_buffer_unref( data->buffer );
 
      direct_mutex_deinit( &data->lock );
@@ -197,89 +208,16 @@ IFusionSoundBuffer_Play( IFusionSoundBuffer *thiz,
      DirectResult  ret;
      CorePlayback *playback;
 
-     DIRECT_INTERFACE_GET_DATA( IFusionSoundBuffer )
-
      D_DEBUG_AT( Buffer, "%s( %p )\n", __FUNCTION__, thiz );
 
-     if (flags & ~FSPLAY_ALL)
-          return DR_INVARG;
-
-     direct_mutex_lock( &data->lock );
-
-     /* Choose looping playback mode. */
-     if (flags & FSPLAY_LOOPING) {
-          /* Return an error if a looping playback is already running. */
-          if (data->looping_playback) {
-               direct_mutex_unlock( &data->lock );
-               return DR_BUSY;
-          }
-
-          /* Create a playback object. */
-          ret = fs_playback_create( data->core, data->buffer, false, &playback );
-          if (ret) {
-               direct_mutex_unlock( &data->lock );
-               return ret;
-          }
-
-          /* Set playback direction. */
-          if (flags & FSPLAY_REWIND)
-               fs_playback_set_pitch( playback, -FS_PITCH_ONE );
-          else
-               fs_playback_set_pitch( playback, +FS_PITCH_ONE );
-
-          /* Set playback start. */
-          fs_playback_set_position( playback, data->pos );
-
-          /* Set looping playback. */
-          fs_playback_set_stop( playback, -1 );
-
-          /* Start the playback. */
-          ret = fs_playback_start( playback, false );
-          if (ret) {
-               fs_playback_unref( playback );
-               direct_mutex_unlock( &data->lock );
-               return ret;
-          }
-
-          /* Remember looping playback. */
-          data->looping_playback = playback;
-     }
-     else {
-          /* Create a playback object. */
-          ret = fs_playback_create( data->core, data->buffer, false, &playback );
-          if (ret) {
-               direct_mutex_unlock( &data->lock );
-               return ret;
-          }
-
-          /* Set playback direction. */
-          if (flags & FSPLAY_REWIND)
-               fs_playback_set_pitch( playback, -FS_PITCH_ONE );
-          else
-               fs_playback_set_pitch( playback, +FS_PITCH_ONE );
-
-          /* Set playback start. */
-          fs_playback_set_position( playback, data->pos );
-
-          /* Set playback end. */
-          if (flags & FSPLAY_CYCLE)
-               fs_playback_set_stop( playback, data->pos );
-          else
-               fs_playback_set_stop( playback, 0 );
-
-          /* Start the playback. */
-          ret = fs_playback_start( playback, false );
-          if (ret) {
-               fs_playback_unref( playback );
-               direct_mutex_unlock( &data->lock );
-               return ret;
-          }
+     ret = IFusionSoundBuffer_PreparePlayback( thiz, flags, &playback );
+     if (ret)
+          return ret;
 
-          /* Object has a global reference while it's being played and is destroyed when the playback has finished. */
-          fs_playback_unref( playback );
-     }
+     /* Start the playback. */
+     ret = fs_playback_start( playback, false );
 
-     direct_mutex_unlock( &data->lock );
+     IFusionSoundBuffer_FinishPlayback( thiz, playback, flags, ret );
 
      return ret;
 }
@@ -287,21 +225,21 @@ IFusionSoundBuffer_Play( IFusionSoundBuffer *thiz,
 static DirectResult
 IFusionSoundBuffer_Stop( IFusionSoundBuffer *thiz )
 {
-     DIRECT_INTERFACE_GET_DATA( IFusionSoundBuffer )
+     DirectResult  ret;
+     CorePlayback *playback;
 
      D_DEBUG_AT( Buffer, "%s( %p )\n", __FUNCTION__, thiz );
 
-     direct_mutex_lock( &data->lock );
+     ret = IFusionSoundBuffer_TakeLoopingPlayback( thiz, &playback );
+     if (ret)
+          return ret;
 
      /* Stop and discard looping playback. */
-     if (data->looping_playback) {
-          fs_playback_stop( data->looping_playback, false );
-          fs_playback_unref( data->looping_playback );
-          data->looping_playback = NULL;
+     if (playback) {
+          fs_playback_stop( playback, false );
+          fs_playback_unref( playback );
      }
 
-     direct_mutex_unlock( &data->lock );
-
      return DR_OK;
 }
 
@@ -382,3 +320,160 @@ IFusionSoundBuffer_Construct( IFusionSoundBuffer *thiz,
 
      return DR_OK;
 }
+
+DirectResult
+IFusionSoundBuffer_PreparePlayback( IFusionSoundBuffer  *thiz,
+                                    FSBufferPlayFlags    flags,
+                                    CorePlayback       **ret_playback )
+{
+     DirectResult  ret;
+     CorePlayback *playback;
+     int           i;
+
+     DIRECT_INTERFACE_GET_DATA( IFusionSoundBuffer )
+
+     D_DEBUG_AT( Buffer, "%s( %p )\n", __FUNCTION__, thiz );
+
+     D_ASSERT( ret_playback != NULL );
+
+     if (flags & ~FSPLAY_ALL)
+          return DR_INVARG;
+
+     direct_mutex_lock( &data->lock );
+
+     /* Choose looping playback mode. */
+     if (flags & FSPLAY_LOOPING) {
+          /* Return an error if a looping playback is already running. */
+          if (data->looping_playback) {
+               direct_mutex_unlock( &data->lock );
+               return DR_BUSY;
+          }
+
+          /* Create a playback object. */
+          ret = fs_playback_create( data->core, data->buffer, false, &playback );
+          if (ret) {
+               direct_mutex_unlock( &data->lock );
+               return ret;
+          }
+
+          /* Remember looping playback, with an additional reference for the caller. */
+          ret = fs_playback_ref( playback );
+          if (ret) {
+               fs_playback_unref( playback );
+               direct_mutex_unlock( &data->lock );
+               return ret;
+          }
+
+          data->looping_playback = playback;
+
+          /* Set looping playback. */
+          fs_playback_set_stop( playback, -1 );
+     }
+     else {
+          /* Take a finished playback object out of the ones kept for reuse, so that it isn't reused meanwhile. */
+          for (i = 0; i < data->num_playbacks; i++) {
+               CorePlaybackStatus status;
+
+               if (fs_playback_get_status( data->playbacks[i], &status, NULL ) == DR_OK && !(status & CPS_PLAYING))
+                    break;
+          }
+
+          if (i < data->num_playbacks) {
+               playback = data->playbacks[i];
+
+               data->playbacks[i] = data->playbacks[--data->num_playbacks];
+          }
+          else {
+               /* Create a playback object. */
+               ret = fs_playback_create( data->core, data->buffer, false, &playback );
+               if (ret) {
+                    direct_mutex_unlock( &data->lock );
+                    return ret;
+               }
+          }
+
+          /* Set playback end. */
+          if (flags & FSPLAY_CYCLE)
+               fs_playback_set_stop( playback, data->pos );
+          else
+               fs_playback_set_stop( playback, 0 );
+     }
+
+     /* Set playback direction. */
+     if (flags & FSPLAY_REWIND)
+          fs_playback_set_pitch( playback, -FS_PITCH_ONE );
+     else
+          fs_playback_set_pitch( playback, +FS_PITCH_ONE );
+
+     /* Set playback start. */
+     fs_playback_set_position( playback, data->pos );
+
+     direct_mutex_unlock( &data->lock );
+
+     *ret_playback = playback;
+
+     return DR_OK;
+}
+
+DirectResult
+IFusionSoundBuffer_FinishPlayback( IFusionSoundBuffer *thiz,
+                                   CorePlayback       *playback,
+                                   FSBufferPlayFlags   flags,
+                                   DirectResult        result )
+{
+     DIRECT_INTERFACE_GET_DATA( IFusionSoundBuffer )
+
+     D_DEBUG_AT( Buffer, "%s( %p, %p )\n", __FUNCTION__, thiz, playback );
+
+     D_ASSERT( playback != NULL );
+
+     direct_mutex_lock( &data->lock );
+
+     if (flags & FSPLAY_LOOPING) {
+          if (data->looping_playback == playback) {
+               /* Forget looping playback if it couldn't be started. */
+               if (result) {
+                    fs_playback_unref( playback );
+                    data->looping_playback = NULL;
+               }
+          }
+          else if (!result) {
+               /* Looping playback has been stopped before it was started. */
+               fs_playback_stop( playback, false );
+          }
+
+          fs_playback_unref( playback );
+     }
+     else {
+          /* Object has a global reference while it's being played, keep ours for reuse if there's room left. */
+          if (data->num_playbacks < MAX_RECYCLED_PLAYBACKS)
+               data->playbacks[data->num_playbacks++] = playback;
+          else
+               fs_playback_unref( playback );
+     }
+
+     direct_mutex_unlock( &data->lock );
+
+     return DR_OK;
+}
+
+DirectResult
+IFusionSoundBuffer_TakeLoopingPlayback( IFusionSoundBuffer  *thiz,
+                                        CorePlayback       **ret_playback )
+{
+     DIRECT_INTERFACE_GET_DATA( IFusionSoundBuffer )
+
+     D_DEBUG_AT( Buffer, "%s( %p )\n", __FUNCTION__, thiz );
+
+     D_ASSERT( ret_playback != NULL );
+
+     direct_mutex_lock( &data->lock );
+
+     *ret_playback = data->looping_playback;
+
+     data->looping_playback = NULL;
+
+     direct_mutex_unlock( &data->lock );
+
+     return DR_OK;
+}
@@ -32,4 +32,24 @@ DirectResult IFusionSoundBuffer_Construct( IFusionSoundBuffer *thiz,
                                            FSSampleFormat      format,
                                            int                 rate );
 
+/*
+ * Set up a playback object for IFusionSoundBuffer::Play() or IFusionSound::StartBatch(), returning a reference to it.
+ * The caller starts the playback and passes the result to IFusionSoundBuffer_FinishPlayback(), which takes over the
+ * reference again.
+ */
+DirectResult IFusionSoundBuffer_PreparePlayback    ( IFusionSoundBuffer  *thiz,
+                                                     FSBufferPlayFlags    flags,
+                                                     CorePlayback       **ret_playback );
+
+DirectResult IFusionSoundBuffer_FinishPlayback     ( IFusionSoundBuffer  *thiz,
+                                                     CorePlayback        *playback,
+                                                     FSBufferPlayFlags    flags,
+                                                     DirectResult         result );
+
+/*
+ * Return the looping playback (if any), passing its reference to the caller.
+ */
+DirectResult IFusionSoundBuffer_TakeLoopingPlayback( IFusionSoundBuffer  *thiz,
+                                                     CorePlayback       **ret_playback );
+
 #endif
@@ -21,6 +21,7 @@
 #include <core/playback.h>
 #include <core/sound_buffer.h>
 #include <direct/memcpy.h>
+#include <misc/sound_event.h>
 #include <playback/ifusionsoundplayback.h>
 
 D_DEBUG_DOMAIN( Stream, "IFusionSoundStream", "IFusionSoundStream Interface" );
@@ -43,6 +44,9 @@ typedef struct {
      FSSampleFormat        format;
      int                   rate;
      int                   prebuffer;
+     FSStreamCapabilities  caps;
+     FSStreamCallback      callback;           /* fills the ring buffer for FSSCAPS_CALLBACK */
+     void                 *callback_ctx;
 
      Reaction              reaction;
 
@@ -54,12 +58,196 @@ typedef struct {
      int                   pos_read;
      int                   filled;
      int                   pending;
+     unsigned int          played;             /* frames played by the playback, accounted in 'filled' */
+     int                   waiting;            /* frames to be played for a blocked writer */
+     unsigned int          written;            /* frames written in total, published by the ring buffer */
+
+     FSEvent               event;              /* readable while Wait( event_length ) would not block */
+     int                   event_length;
 
      IFusionSoundPlayback *playback;
 } IFusionSoundStream_data;
 
 /**********************************************************************************************************************/
 
+/*
+ * Update the event descriptor and the watermark of the playback, the stream being locked. The watermark is set while
+ * a writer is blocked or the event descriptor is waiting for free space.
+ */
+static void
+UpdateEvent( IFusionSoundStream_data *data )
+{
+     int frames = data->waiting;
+
+     if (data->event.fd >= 0) {
+          bool ring    = data->caps & FSSCAPS_RING;
+          int  missing = data->event_length - (data->buffersize - data->filled);
+
+          /* Ring buffer playbacks don't stop, they're finished once all frames have been played. */
+          if (!data->event_length && ring)
+               missing = data->playing ? data->filled : 0;
+
+          if (data->event_length || ring)
+               fs_event_set( &data->event, missing <= 0 );
+          else
+               fs_event_set( &data->event, !data->playing );
+
+          if ((data->event_length || ring) && missing > 0 && (!frames || missing < frames))
+               frames = missing;
+     }
+
+     if (frames)
+          fs_playback_set_watermark( data->streaming_playback, data->played + frames );
+     else
+          fs_playback_clear_watermark( data->streaming_playback );
+}
+
+/*
+ * Account for the frames played since the last update, the stream being locked.
+ */
+static void
+UpdateFilled( IFusionSoundStream_data *data )
+{
+     unsigned int played;
+     int          position;
+
+     /* The read index of a ring buffer is the number of frames played, the position being in step with it. */
+     if (data->caps & FSSCAPS_RING) {
+          unsigned int written;
+
+          fs_buffer_ring_get( data->buffer, &written, &played );
+
+          position = played % data->buffersize;
+
+          /* Account for the frames written by the fill callback. */
+          if (data->caps & FSSCAPS_CALLBACK) {
+               data->filled    += written - data->written;
+               data->written    = written;
+               data->pos_write  = written % data->buffersize;
+          }
+     }
+     else if (fs_playback_get_played( data->streaming_playback, &played, &position ))
+          return;
+
+     D_ASSERT( data->filled >= (int) (played - data->played) );
+
+     if (played == data->played)
+          return;
+
+     data->filled   -= played - data->played;
+     data->played    = played;
+     data->pos_read  = position;
+
+     UpdateEvent( data );
+}
+
+/*
+ * Wait until 'frames' more frames have been played or the playback state changes, the stream being locked. The
+ * playback only notifies progress while a watermark is set.
+ */
+static void
+WaitPlayed( IFusionSoundStream_data *data,
+            int                      frames )
+{
+     unsigned int played = data->played;
+
+     data->waiting = frames;
+
+     UpdateEvent( data );
+
+     /* Don't wait for frames played before the watermark has been set. */
+     UpdateFilled( data );
+
+     if (data->played == played)
+          direct_waitqueue_wait( &data->wait, &data->lock );
+
+     data->waiting = 0;
+
+     UpdateEvent( data );
+}
+
+/*
+ * Copy frames to the ring buffer at the write position, the stream being locked and the frames fitting into the free
+ * space.
+ */
+static DirectResult
+CopyFrames( IFusionSoundStream_data *data,
+            const void              *sample_data,
+            int                      length )
+{
+     DirectResult  ret;
+     void         *lock_data;
+     int           lock_bytes;
+
+     D_ASSERT( length <= data->buffersize - data->filled );
+
+     /* Fill free space with automatic wrap around to the beginning. */
+     while (length) {
+          int num = MIN( length, data->buffersize - data->pos_write );
+
+          /* Write data. */
+          ret = fs_buffer_lock( data->buffer, data->pos_write, num, &lock_data, &lock_bytes );
+          if (ret)
+               return ret;
+
+          direct_memcpy( lock_data, sample_data, lock_bytes );
+
+          fs_buffer_unlock( data->buffer );
+
+          /* Update parameters. */
+          length      -= num;
+          sample_data += lock_bytes;
+
+          /* Update write position. */
+          data->pos_write += num;
+
+          /* Handle wrap around. */
+          if (data->pos_write == data->buffersize)
+               data->pos_write = 0;
+     }
+
+     return DR_OK;
+}
+
+/*
+ * Hand frames copied to the ring buffer over to the playback, starting it once enough frames are buffered, the stream
+ * being locked.
+ */
+static DirectResult
+SubmitFrames( IFusionSoundStream_data *data,
+              int                      length )
+{
+     DirectResult ret;
+
+     if (data->caps & FSSCAPS_RING) {
+          /* Hand the frames over to the sound thread. */
+          data->written += length;
+
+          fs_buffer_ring_write( data->buffer, data->written );
+     }
+     else {
+          /* Set new stop position. */
+          ret = fs_playback_set_stop( data->streaming_playback, data->pos_write );
+          if (ret)
+               return ret;
+
+          /* (Re)enable playback if the buffer is empty. */
+          fs_playback_enable( data->streaming_playback );
+     }
+
+     /* Update fill level. */
+     data->filled += length;
+
+     /* (Re)start if playback is stopped. */
+     if (!data->playing && data->prebuffer >= 0 && data->filled >= data->prebuffer) {
+          D_DEBUG_AT( Stream, "  -> starting playback\n" );
+
+          fs_playback_start( data->streaming_playback, true );
+     }
+
+     return DR_OK;
+}
+
 static void
 IFusionSoundStream_Destruct( IFusionSoundStream *thiz )
 {
@@ -74,8 +262,11 @@ IFusionSoundStream_Destruct( IFusionSoundStream *thiz )
      fs_playback_stop( data->streaming_playback, true );
      fs_playback_unref( data->streaming_playback );
 
+     fs_buffer_ring_pull_deinit( data->buffer );
      fs_buffer_unref( data->buffer );
 
+     fs_event_deinit( &data->event );
+
      direct_waitqueue_deinit( &data->wait );
      direct_mutex_deinit( &data->lock );
 
@@ -119,7 +310,7 @@ IFusionSoundStream_GetDescription( IFusionSoundStream  *thiz,
           return DR_INVARG;
 
      ret_desc->flags = FSSDF_BUFFERSIZE | FSSDF_CHANNELS | FSSDF_SAMPLEFORMAT | FSSDF_SAMPLERATE | FSSDF_PREBUFFER |
-                       FSSDF_CHANNELMODE;
+                       FSSDF_CHANNELMODE | FSSDF_CAPS;
 
      ret_desc->buffersize   = data->buffersize;
      ret_desc->channels     = FS_CHANNELS_FOR_MODE( data->mode );
@@ -127,6 +318,9 @@ IFusionSoundStream_GetDescription( IFusionSoundStream  *thiz,
      ret_desc->samplerate   = data->rate;
      ret_desc->prebuffer    = data->prebuffer;
      ret_desc->channelmode  = data->mode;
+     ret_desc->caps         = data->caps;
+     ret_desc->callback     = data->callback;
+     ret_desc->callback_ctx = data->callback_ctx;
 
      return DR_OK;
 }
@@ -145,24 +339,26 @@ IFusionSoundStream_Write( IFusionSoundStream *thiz,
      if (!sample_data || length < 1)
           return DR_INVARG;
 
+     if (data->caps & FSSCAPS_CALLBACK)
+          return DR_UNSUPPORTED;
+
      direct_mutex_lock( &data->lock );
 
      data->pending = length;
 
+     UpdateFilled( data );
+
      while (data->pending) {
-          int   num, size;
-          void *lock_data;
-          int   lock_bytes;
-          int   bytes = 0;
+          int num;
 
           D_DEBUG_AT( Stream, "  -> length %d, read pos %d, write pos %d, filled %d/%d (%splaying)\n", data->pending,
                       data->pos_read, data->pos_write, data->filled, data->buffersize, data->playing ? "" : "not " );
 
           D_ASSERT( data->filled <= data->buffersize );
 
-          /* Wait for at least one free sample. */
+          /* Wait for at least one free sample, letting the playback notify once half of the buffer is free. */
           while (data->filled == data->buffersize) {
-               direct_waitqueue_wait( &data->wait, &data->lock );
+               WaitPlayed( data, MAX( MIN( data->pending, data->buffersize / 2 ), 1 ) );
 
                /* Drop() could have been called while waiting. */
                if (!data->pending)
@@ -176,53 +372,16 @@ IFusionSoundStream_Write( IFusionSoundStream *thiz,
           if (num > data->pending)
                num = data->pending;
 
-          size = num;
-
-          /* Fill free space with automatic wrap around to the beginning. */
-          while (size) {
-               length = MIN( size, data->buffersize - data->pos_write );
-
-               /* Write data. */
-               ret = fs_buffer_lock( data->buffer, data->pos_write, length, &lock_data, &lock_bytes );
-               if (ret)
-                    goto out;
-
-               direct_memcpy( lock_data, sample_data + bytes, lock_bytes );
-
-               fs_buffer_unlock( data->buffer );
-
-               /* Update parameters. */
-               size -= length;
-               bytes += lock_bytes;
-
-               /* Update write position. */
-               data->pos_write += length;
-
-               /* Handle wrap around. */
-               if (data->pos_write == data->buffersize)
-                    data->pos_write = 0;
-
-               /* Set new stop position. */
-               ret = fs_playback_set_stop( data->streaming_playback, data->pos_write );
-               if (ret)
-                    goto out;
-
-               /* (Re)enable playback if the buffer is empty. */
-               fs_playback_enable( data->streaming_playback );
-
-               /* Update fill level. */
-               data->filled += length;
-          }
-
-          /* (Re)start if playback is stopped. */
-          if (!data->playing && data->prebuffer >= 0 && data->filled >= data->prebuffer) {
-               D_DEBUG_AT( Stream, "  -> starting playback\n" );
+          ret = CopyFrames( data, sample_data, num );
+          if (ret)
+               goto out;
 
-               fs_playback_start( data->streaming_playback, true );
-          }
+          ret = SubmitFrames( data, num );
+          if (ret)
+               goto out;
 
           /* Update input sample data (sample data that has not yet been written). */
-          sample_data += bytes;
+          sample_data += num * fs_buffer_bytes( data->buffer );
 
           /* Update amount of pending data. */
           if (data->pending)
@@ -230,6 +389,8 @@ IFusionSoundStream_Write( IFusionSoundStream *thiz,
      }
 
 out:
+     UpdateEvent( data );
+
      direct_mutex_unlock( &data->lock );
 
      return ret;
@@ -248,6 +409,8 @@ IFusionSoundStream_Wait( IFusionSoundStream *thiz,
 
      direct_mutex_lock( &data->lock );
 
+     UpdateFilled( data );
+
      while (true) {
           if (length) {
                int num;
@@ -257,11 +420,20 @@ IFusionSoundStream_Wait( IFusionSoundStream *thiz,
 
                if (num >= length)
                     break;
+
+               WaitPlayed( data, length - num );
           }
           else if (!data->playing)
                break;
+          else if (data->caps & FSSCAPS_RING) {
+               /* The playback keeps running, wait for all frames to be played. */
+               if (!data->filled)
+                    break;
 
-          direct_waitqueue_wait( &data->wait, &data->lock );
+               WaitPlayed( data, data->filled );
+          }
+          else
+               direct_waitqueue_wait( &data->wait, &data->lock );
      }
 
      direct_mutex_unlock( &data->lock );
@@ -283,6 +455,8 @@ IFusionSoundStream_GetStatus( IFusionSoundStream *thiz,
 
      direct_mutex_lock( &data->lock );
 
+     UpdateFilled( data );
+
      if (filled)
           *filled = data->filled;
 
@@ -319,12 +493,27 @@ IFusionSoundStream_Flush( IFusionSoundStream *thiz )
           direct_waitqueue_wait( &data->wait, &data->lock );
      }
 
+     /* Account for the frames played until the playback stopped. */
+     UpdateFilled( data );
+
      /* Reset the buffer. */
      data->pos_write = data->pos_read;
      data->filled    = 0;
 
+     if (data->caps & FSSCAPS_RING) {
+          data->written = data->played;
+
+          fs_buffer_ring_write( data->buffer, data->written );
+     }
+
+     UpdateEvent( data );
+
      direct_mutex_unlock( &data->lock );
 
+     /* Restart playback, filled by the callback from now on. */
+     if ((data->caps & FSSCAPS_CALLBACK) && data->prebuffer >= 0)
+          fs_playback_start( data->streaming_playback, true );
+
      return DR_OK;
 }
 
@@ -360,6 +549,8 @@ IFusionSoundStream_GetPresentationDelay( IFusionSoundStream *thiz,
 
      direct_mutex_lock( &data->lock );
 
+     UpdateFilled( data );
+
      *ret_delay = fs_core_output_delay( data->core ) + (data->filled + data->pending) * 1000 / data->rate;
 
      direct_mutex_unlock( &data->lock );
@@ -414,6 +605,9 @@ IFusionSoundStream_Access( IFusionSoundStream  *thiz,
      if (!ret_data || !ret_frames)
           return DR_INVARG;
 
+     if (data->caps & FSSCAPS_CALLBACK)
+          return DR_UNSUPPORTED;
+
      direct_mutex_lock( &data->lock );
 
      D_DEBUG_AT( Stream, "  -> read pos %d, write pos %d, filled %d/%d (%splaying)\n",
@@ -421,17 +615,16 @@ IFusionSoundStream_Access( IFusionSoundStream  *thiz,
 
      D_ASSERT( data->filled <= data->buffersize );
 
+     UpdateFilled( data );
+
      /* Wait for at least one free sample. */
      while (data->filled == data->buffersize) {
-          direct_waitqueue_wait( &data->wait, &data->lock );
+          WaitPlayed( data, 1 );
      }
 
-     /* Calculate the number of free samples in the buffer. */
+     /* Calculate the number of free samples in the buffer, which are contiguous as the buffer is mirrored. */
      length = data->buffersize - data->filled;
 
-     if (length > data->buffersize - data->pos_write)
-          length = data->buffersize - data->pos_write;
-
      ret = fs_buffer_lock( data->buffer, data->pos_write, length, ret_data, &bytes );
 
      *ret_frames = ret ? 0 : length;
@@ -454,8 +647,13 @@ IFusionSoundStream_Commit( IFusionSoundStream  *thiz,
      if (length < 0)
           return DR_INVARG;
 
+     if (data->caps & FSSCAPS_CALLBACK)
+          return DR_UNSUPPORTED;
+
      direct_mutex_lock( &data->lock );
 
+     UpdateFilled( data );
+
      if (length > data->buffersize - data->filled) {
           ret = DR_INVARG;
           goto out;
@@ -467,33 +665,192 @@ IFusionSoundStream_Commit( IFusionSoundStream  *thiz,
      fs_buffer_unlock( data->buffer );
 
      if (length) {
+          /* Move samples written past the end to the beginning. */
+          if (data->pos_write + length > data->buffersize)
+               fs_buffer_wrap( data->buffer, data->pos_write + length - data->buffersize );
+
           /* Update write position. */
           data->pos_write += length;
 
           /* Handle wrap around. */
-          if (data->pos_write == data->buffersize)
-               data->pos_write = 0;
+          if (data->pos_write >= data->buffersize)
+               data->pos_write -= data->buffersize;
 
-          /* Set new stop position. */
-          ret = fs_playback_set_stop( data->streaming_playback, data->pos_write );
-          if (ret)
-               goto out;
+          ret = SubmitFrames( data, length );
+     }
 
-          /* (Re)enable playback if the buffer is empty. */
-          fs_playback_enable( data->streaming_playback );
+out:
+     UpdateEvent( data );
 
-          /* Update fill level. */
-          data->filled += length;
+     direct_mutex_unlock( &data->lock );
 
-          /* (Re)start if playback is stopped. */
-          if (!data->playing && data->prebuffer >= 0 && data->filled >= data->prebuffer) {
-               D_DEBUG_AT( Stream, "  -> starting playback\n" );
+     return ret;
+}
 
-               fs_playback_start( data->streaming_playback, true );
+static DirectResult
+IFusionSoundStream_CreateFileDescriptor( IFusionSoundStream *thiz,
+                                         int                 length,
+                                         int                *ret_fd )
+{
+     DirectResult ret;
+
+     DIRECT_INTERFACE_GET_DATA( IFusionSoundStream )
+
+     D_DEBUG_AT( Stream, "%s( %p, %d )\n", __FUNCTION__, thiz, length );
+
+     if (length < 0 || length > data->buffersize || !ret_fd)
+          return DR_INVARG;
+
+     direct_mutex_lock( &data->lock );
+
+     UpdateFilled( data );
+
+     ret = fs_event_create( &data->event, false, ret_fd );
+     if (ret == DR_OK) {
+          data->event_length = length;
+
+          UpdateEvent( data );
+     }
+
+     direct_mutex_unlock( &data->lock );
+
+     return ret;
+}
+
+static DirectResult
+IFusionSoundStream_TryWrite( IFusionSoundStream *thiz,
+                             const void         *sample_data,
+                             int                 length,
+                             int                *ret_written )
+{
+     DirectResult ret = DR_OK;
+     int          num;
+
+     DIRECT_INTERFACE_GET_DATA( IFusionSoundStream )
+
+     D_DEBUG_AT( Stream, "%s( %p, %d )\n", __FUNCTION__, thiz, length );
+
+     if (!sample_data || length < 1 || !ret_written)
+          return DR_INVARG;
+
+     /* Only ring buffers are handed over without waiting for the playback. */
+     if (!(data->caps & FSSCAPS_RING) || (data->caps & FSSCAPS_CALLBACK))
+          return DR_UNSUPPORTED;
+
+     direct_mutex_lock( &data->lock );
+
+     UpdateFilled( data );
+
+     /* Write what fits into the free space. */
+     num = MIN( length, data->buffersize - data->filled );
+
+     /* Reaching the prebuffer amount starts a stopped playback, which may block on the playlist lock. */
+     if (num) {
+          ret = CopyFrames( data, sample_data, num );
+          if (ret == DR_OK)
+               ret = SubmitFrames( data, num );
+     }
+
+     *ret_written = ret ? 0 : num;
+
+     D_DEBUG_AT( Stream, "  -> wrote %d, filled %d/%d\n", *ret_written, data->filled, data->buffersize );
+
+     UpdateEvent( data );
+
+     direct_mutex_unlock( &data->lock );
+
+     return ret;
+}
+
+static DirectResult
+IFusionSoundStream_Writev( IFusionSoundStream     *thiz,
+                           const FSStreamFragment *fragments,
+                           int                     num )
+{
+     DirectResult ret    = DR_OK;
+     int          total  = 0;
+     int          index  = 0;
+     int          offset = 0;
+     int          i;
+
+     DIRECT_INTERFACE_GET_DATA( IFusionSoundStream )
+
+     D_DEBUG_AT( Stream, "%s( %p, %d )\n", __FUNCTION__, thiz, num );
+
+     if (!fragments || num < 1)
+          return DR_INVARG;
+
+     for (i = 0; i < num; i++) {
+          if (!fragments[i].data || fragments[i].length < 0)
+               return DR_INVARG;
+
+          total += fragments[i].length;
+     }
+
+     if (total < 1)
+          return DR_INVARG;
+
+     if (data->caps & FSSCAPS_CALLBACK)
+          return DR_UNSUPPORTED;
+
+     direct_mutex_lock( &data->lock );
+
+     data->pending = total;
+
+     UpdateFilled( data );
+
+     while (data->pending) {
+          int space;
+          int copied = 0;
+
+          D_DEBUG_AT( Stream, "  -> length %d, read pos %d, write pos %d, filled %d/%d (%splaying)\n", data->pending,
+                      data->pos_read, data->pos_write, data->filled, data->buffersize, data->playing ? "" : "not " );
+
+          D_ASSERT( data->filled <= data->buffersize );
+
+          /* Wait for at least one free sample, letting the playback notify once half of the buffer is free. */
+          while (data->filled == data->buffersize) {
+               WaitPlayed( data, MAX( MIN( data->pending, data->buffersize / 2 ), 1 ) );
+
+               /* Drop() could have been called while waiting. */
+               if (!data->pending)
+                    goto out;
+          }
+
+          /* Calculate the number of free samples in the buffer, not writing more than requested. */
+          space = MIN( data->buffersize - data->filled, data->pending );
+
+          /* Copy as many fragments as fit, continuing within the current one. */
+          while (copied < space) {
+               const FSStreamFragment *fragment = &fragments[index];
+               int                     length   = MIN( fragment->length - offset, space - copied );
+
+               ret = CopyFrames( data, fragment->data + offset * fs_buffer_bytes( data->buffer ), length );
+               if (ret)
+                    goto out;
+
+               copied += length;
+               offset += length;
+
+               if (offset == fragment->length) {
+                    index++;
+                    offset = 0;
+               }
           }
+
+          /* Update the playback once for all of them. */
+          ret = SubmitFrames( data, copied );
+          if (ret)
+               goto out;
+
+          /* Update amount of pending data. */
+          if (data->pending)
+               data->pending -= copied;
      }
 
 out:
+     UpdateEvent( data );
+
      direct_mutex_unlock( &data->lock );
 
      return ret;
@@ -505,34 +862,40 @@ IFusionSoundStream_React( const void *msg_data,
 {
      const CorePlaybackNotification *notification = msg_data;
      IFusionSoundStream_data        *data         = ctx;
+     CorePlaybackStatus              status;
 
      D_DEBUG_AT( Stream, "%s( %p, %p )\n", __FUNCTION__, notification, data );
 
+     /* Use the current status, a notification may arrive after the playback has been restarted or stopped. */
+     fs_playback_get_status( data->streaming_playback, &status, NULL );
+
+     direct_mutex_lock( &data->lock );
+
      if (notification->flags & CPNF_START) {
           D_DEBUG_AT( Stream, "  -> playback started at position %d\n", notification->pos );
 
-          data->playing = true;
+          data->playing = !!(status & CPS_PLAYING);
+
+          UpdateEvent( data );
+
+          direct_mutex_unlock( &data->lock );
 
           return RS_OK;
      }
 
-     direct_mutex_lock( &data->lock );
-
-     if (notification->flags & CPNF_ADVANCE) {
+     if (notification->flags & CPNF_ADVANCE)
           D_DEBUG_AT( Stream, "  -> playback advanced by %d from position %d to position %d\n",
                       notification->num, data->pos_read, notification->pos );
 
-          D_ASSERT( data->filled >= notification->num );
-
-          data->filled -= notification->num;
-     }
-
-     data->pos_read = notification->pos;
+     /* Account for the frames played up to now, which may be more than notified. */
+     UpdateFilled( data );
 
      if (notification->flags & CPNF_STOP) {
           D_DEBUG_AT( Stream, "  -> playback stopped at position %d\n", notification->pos );
 
-          data->playing = false;
+          data->playing = !!(status & CPS_PLAYING);
+
+          UpdateEvent( data );
      }
 
      direct_waitqueue_broadcast( &data->wait );
@@ -542,15 +905,74 @@ IFusionSoundStream_React( const void *msg_data,
      return RS_OK;
 }
 
+/*
+ * Fill the ring buffer using the callback, called by the sound thread with the number of frames needed for mixing.
+ * The callback is the only writer of the ring buffer, which is accessed without locking the stream.
+ */
+static FusionCallHandlerResult
+IFusionSoundStream_Fill( int           caller,
+                         int           call_arg,
+                         void         *call_ptr,
+                         void         *ctx,
+                         unsigned int  serial,
+                         int          *ret_val )
+{
+     DirectResult             ret;
+     IFusionSoundStream_data *data = ctx;
+     unsigned int             written;
+     unsigned int             read;
+     int                      pos;
+     int                      length;
+     int                      num;
+     void                    *lock_data;
+     int                      lock_bytes;
+
+     D_DEBUG_AT( Stream, "%s( %p, %d )\n", __FUNCTION__, data, call_arg );
+
+     fs_buffer_ring_get( data->buffer, &written, &read );
+
+     /* Do not write more than there's free space, which is contiguous as the buffer is mirrored. */
+     pos    = written % data->buffersize;
+     length = MIN( call_arg, data->buffersize - (int) (written - read) );
+
+     ret = fs_buffer_lock( data->buffer, pos, length, &lock_data, &lock_bytes );
+     if (ret) {
+          *ret_val = ret;
+          return FCHR_RETURN;
+     }
+
+     num = data->callback( lock_data, length, data->callback_ctx );
+     if (num < 0)
+          num = 0;
+     else if (num > length)
+          num = length;
+
+     /* Move samples written past the end to the beginning. */
+     if (pos + num > data->buffersize)
+          fs_buffer_wrap( data->buffer, pos + num - data->buffersize );
+
+     fs_buffer_unlock( data->buffer );
+
+     /* Hand the frames over to the sound thread. */
+     fs_buffer_ring_write( data->buffer, written + num );
+
+     *ret_val = DR_OK;
+
+     return FCHR_RETURN;
+}
+
 DirectResult
-IFusionSoundStream_Construct( IFusionSoundStream *thiz,
-                              CoreSound          *core,
-                              CoreSoundBuffer    *buffer,
-                              int                 buffersize,
-                              FSChannelMode       mode,
-                              FSSampleFormat      format,
-                              int                 rate,
-                              int                 prebuffer )
+IFusionSoundStream_Construct( IFusionSoundStream   *thiz,
+                              CoreSound            *core,
+                              CoreSoundBuffer      *buffer,
+                              int                   buffersize,
+                              FSChannelMode         mode,
+                              FSSampleFormat        format,
+                              int                   rate,
+                              int                   prebuffer,
+                              FSStreamCapabilities  caps,
+                              FSStreamCallback      callback,
+                              void                 *callback_ctx )
 {
      DirectResult  ret;
      CorePlayback *playback;
@@ -585,6 +1007,22 @@ IFusionSoundStream_Construct( IFusionSoundStream *thiz,
      /* Disable playback. */
      fs_playback_stop( playback, true );
 
+     /* Hand written frames to the sound thread through the ring indices. */
+     if (caps & FSSCAPS_RING)
+          fs_buffer_ring_enable( buffer );
+
+     /* Let the sound thread request frames from the fill callback. */
+     if (caps & FSSCAPS_CALLBACK) {
+          ret = fs_buffer_ring_pull_init( buffer, fs_core_world( core ), IFusionSoundStream_Fill, data );
+          if (ret) {
+               fs_playback_detach( playback, &data->reaction );
+               fs_buffer_unref( buffer );
+               fs_playback_unref( playback );
+               DIRECT_DEALLOCATE_INTERFACE( thiz );
+               return ret;
+          }
+     }
+
      data->ref                = 1;
      data->core               = core;
      data->buffer             = buffer;
@@ -594,10 +1032,15 @@ IFusionSoundStream_Construct( IFusionSoundStream *thiz,
      data->format             = format;
      data->rate               = rate;
      data->prebuffer          = prebuffer;
+     data->caps               = caps;
+     data->callback           = callback;
+     data->callback_ctx       = callback_ctx;
 
      direct_recursive_mutex_init( &data->lock );
      direct_waitqueue_init( &data->wait );
 
+     fs_event_init( &data->event );
+
      thiz->AddRef               = IFusionSoundStream_AddRef;
      thiz->Release              = IFusionSoundStream_Release;
      thiz->GetDescription       = IFusionSoundStream_GetDescription;
@@ -610,6 +1053,13 @@ IFusionSoundStream_Construct( IFusionSoundStream *thiz,
      thiz->GetPlayback          = IFusionSoundStream_GetPlayback;
      thiz->Access               = IFusionSoundStream_Access;
      thiz->Commit               = IFusionSoundStream_Commit;
+     thiz->CreateFileDescriptor = IFusionSoundStream_CreateFileDescriptor;
+     thiz->TryWrite             = IFusionSoundStream_TryWrite;
+     thiz->Writev               = IFusionSoundStream_Writev;
+
+     /* Start playback, no frames need to be buffered in advance. */
+     if ((caps & FSSCAPS_CALLBACK) && prebuffer >= 0)
+          fs_playback_start( playback, true );
 
      return DR_OK;
 }
@@ -24,13 +24,16 @@
 /*
  * initializes interface struct and private data
  */
-DirectResult IFusionSoundStream_Construct( IFusionSoundStream *thiz,
-                                           CoreSound          *core,
-                                           CoreSoundBuffer    *buffer,
-                                           int                 buffersize,
-                                           FSChannelMode       mode,
-                                           FSSampleFormat      format,
-                                           int                 rate,
-                                           int                 prebuffer );
+DirectResult IFusionSoundStream_Construct( IFusionSoundStream   *thiz,
+                                           CoreSound            *core,
+                                           CoreSoundBuffer      *buffer,
+                                           int                   buffersize,
+                                           FSChannelMode         mode,
+                                           FSSampleFormat        format,
+                                           int                   rate,
+                                           int                   prebuffer,
+                                           FSStreamCapabilities  caps,
+                                           FSStreamCallback      callback,
+                                           void                 *callback_ctx );
 
 #endif
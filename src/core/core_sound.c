@@ -21,6 +21,9 @@
 #include <core/playback.h>
 #include <core/sound_buffer.h>
 #include <core/sound_device.h>
+#include <core/sound_simd.h>
+#include <core/sound_sinc.h>
+#include <direct/atomic.h>
 #include <direct/direct.h>
 #include <direct/signals.h>
 #include <direct/thread.h>
@@ -34,6 +37,16 @@ D_DEBUG_DOMAIN( CoreSound_Main, "CoreSound/Main", "FusionSound Core" );
 
 /**********************************************************************************************************************/
 
+/*
+ * Copy of the playlist published to the sound thread, which reads it without locking.
+ */
+typedef struct {
+     unsigned int          generation;
+     int                   num;
+     int                   size;
+     CorePlaylistEntry   **entries;
+} CorePlaylistSnapshot;
+
 typedef struct {
      FusionObjectPool      *buffer_pool;
      FusionObjectPool      *playback_pool;
@@ -41,8 +54,14 @@ typedef struct {
      FusionSHMPoolShared   *shmpool;
 
      struct {
-          DirectLink       *entries;
-          FusionSkirmish    lock;
+          DirectLink           *entries;        /* modified with the lock held */
+          FusionSkirmish        lock;
+          DirectLink           *retired;        /* removed entries, possibly still in use by the sound thread */
+          CorePlaylistSnapshot  snapshots[3];
+          int                   current;        /* snapshot published last */
+          int                   active;         /* snapshot used by the sound thread */
+          unsigned int          generation;
+          int                   batch;          /* publishing deferred while starting or stopping a batch */
      } playlist;
 
      FSDeviceDescription    description;
@@ -61,6 +80,39 @@ typedef struct {
      __fsf                  master_feedback_right;
 } CoreSoundShared;
 
+/*
+ * Playlist entry to be mixed in a cycle and its result.
+ */
+typedef struct {
+     CorePlaylistEntry *entry;
+     DirectResult       ret;
+} CoreSoundMixJob;
+
+/*
+ * State of a playback before starting it with a batch.
+ */
+typedef struct {
+     bool               started;    /* started by the batch, not running before */
+     bool               moved;      /* range changed before starting it */
+     int                position;   /* previous position */
+     int                stop;       /* previous stop position */
+} CoreBatchState;
+
+/*
+ * Mixing worker, mixing its share of the playlist into its own mixing buffer.
+ */
+typedef struct {
+     CoreSound         *core;
+     DirectThread      *thread;
+     int                index;      /* share of the playlist, 0 being the sound thread */
+
+     void              *buffer;
+     __fsf             *planes[6];
+
+     int                mixed;      /* number of frames written in the current cycle */
+     unsigned int       dirty;      /* planes written in the current cycle */
+} CoreSoundMixer;
+
 struct __FS_CoreSound {
      int                   refs;
 
@@ -76,12 +128,27 @@ struct __FS_CoreSound {
      DirectThread         *sound_thread;
 
      void                 *mixing_buffer;
+     __fsf                *mixing_planes[6];
+     void                 *output_buffer;
+
+     CoreSoundMixer       *mixers;          /* mixing threads besides the sound thread */
+     int                   num_mixers;
+     DirectMutex           mix_lock;
+     DirectWaitQueue       mix_start;
+     DirectWaitQueue       mix_done;
+     unsigned int          mix_cycle;
+     int                   mix_pending;
+     CoreSoundMixJob      *mix_jobs;
+     int                   mix_num;
+     int                   mix_size;
+     int                   mix_next;
 
      DirectSignalHandler  *signal_handler;
 
      DirectCleanupHandler *cleanup_handler;
 
      float                 volume;
+     CoreSoundClient      *client;          /* local client settings */
 
      bool                  master;
 
@@ -99,6 +166,10 @@ static void fs_core_deinit_check( void *ctx );
 
 static void *fs_sound_thread( DirectThread *thread, void *arg );
 
+static void fs_core_start_mixers( CoreSound *core );
+
+static DirectResult fs_core_playlist_publish( CoreSoundShared *shared );
+
 static DirectResult fs_core_shutdown( CoreSound *core, bool local );
 
 static DirectSignalHandlerResult fs_core_signal_handler( int num, void *addr, void *ctx );
@@ -108,11 +179,6 @@ static int fs_core_arena_shutdown  ( FusionArena *arena, void *ctx, bool emergen
 static int fs_core_arena_join      ( FusionArena *arena, void *ctx );
 static int fs_core_arena_leave     ( FusionArena *arena, void *ctx, bool emergency );
 
-typedef struct {
-     DirectLink    link;
-     CorePlayback *playback;
-} CorePlaylistEntry;
-
 enum {
      CSCID_GET_VOLUME,
      CSCID_SET_VOLUME,
@@ -275,6 +341,8 @@ fs_core_destroy( CoreSound *core,
 
                          case 0:
                               core->detached = true;
+                              /* Restart mixing threads. */
+                              fs_core_start_mixers( core );
                               /* Restart sound thread. */
                               if (core->sound_thread)
                                    core->sound_thread = direct_thread_create( DTT_OUTPUT, fs_sound_thread, core,
@@ -403,6 +471,7 @@ DirectResult
 fs_core_add_playback( CoreSound    *core,
                       CorePlayback *playback )
 {
+     DirectResult       ret;
      CorePlaylistEntry *entry;
      CoreSoundShared   *shared;
 
@@ -414,19 +483,35 @@ fs_core_add_playback( CoreSound    *core,
 
      shared = core->shared;
 
-     /* Allocate playlist entry. */
-     entry = SHCALLOC( shared->shmpool, 1, sizeof(CorePlaylistEntry) );
-     if (!entry)
-          return DR_NOLOCALMEMORY;
+     entry = fs_playback_entry( playback );
 
-     /* Link playback to playlist entry. */
-     if (fs_playback_link( &entry->playback, playback )) {
-          SHFREE( shared->shmpool, entry );
-          return DR_FUSION;
+     /* Link playback to its playlist entry, unless still referenced by a snapshot. */
+     if (!entry->playback) {
+          if (fs_playback_link( &entry->playback, playback ))
+               return DR_FUSION;
+
+          direct_list_prepend( &shared->playlist.entries, &entry->link );
+     }
+     else if (entry->retired) {
+          direct_list_remove( &shared->playlist.retired, &entry->link );
+
+          entry->retired = false;
+
+          direct_list_prepend( &shared->playlist.entries, &entry->link );
      }
 
-     /* Add it to the playback list. */
-     direct_list_prepend( &shared->playlist.entries, &entry->link );
+     entry->finished = false;
+
+     /* Published at the end of a batch. */
+     if (shared->playlist.batch)
+          return DR_OK;
+
+     /* Publish the new playlist to the sound thread, the entry is retired with a later snapshot on failure. */
+     ret = fs_core_playlist_publish( shared );
+     if (ret) {
+          entry->finished = true;
+          return ret;
+     }
 
      /* Notify new playlist entry to the sound thread. */
      fusion_skirmish_notify( &shared->playlist.lock );
@@ -438,7 +523,7 @@ DirectResult
 fs_core_remove_playback( CoreSound    *core,
                          CorePlayback *playback )
 {
-     CorePlaylistEntry *entry, *next;
+     CorePlaylistEntry *entry;
      CoreSoundShared   *shared;
 
      D_DEBUG_AT( CoreSound_Main, "%s( %p )\n", __FUNCTION__, playback );
@@ -449,17 +534,152 @@ fs_core_remove_playback( CoreSound    *core,
 
      shared = core->shared;
 
-     /* Lookup playback to remove in the list. */
-     direct_list_foreach_safe (entry, next, shared->playlist.entries) {
-          if (entry->playback == playback) {
-               direct_list_remove( &shared->playlist.entries, &entry->link );
+     entry = fs_playback_entry( playback );
 
-               fs_playback_unlink( &entry->playback );
+     /* Mark the entry as finished, the sound thread skips it from now on. */
+     if (entry->playback && !entry->retired)
+          entry->finished = true;
+
+     /* Publish the playlist without the finished entries, they are removed with a later snapshot on failure. */
+     if (!shared->playlist.batch)
+          fs_core_playlist_publish( shared );
+
+     return DR_OK;
+}
+
+DirectResult
+fs_core_start_playbacks( CoreSound     *core,
+                         CorePlayback **playbacks,
+                         const int     *positions,
+                         const int     *stops,
+                         int            num )
+{
+     DirectResult        ret = DR_OK;
+     CoreSoundShared    *shared;
+     CorePlaybackStatus  status;
+     CoreBatchState     *states;
+     int                 i, n;
+
+     D_DEBUG_AT( CoreSound_Main, "%s( %p, %d )\n", __FUNCTION__, playbacks, num );
+
+     D_ASSERT( core != NULL );
+     D_ASSERT( core->shared != NULL );
+     D_ASSERT( playbacks != NULL || num == 0 );
+     D_ASSERT( !positions == !stops );
+
+     shared = core->shared;
+
+     /* Remember the playbacks started by this batch, others may have been running already. */
+     states = D_CALLOC( num ?: 1, sizeof(CoreBatchState) );
+     if (!states)
+          return D_OOM();
 
-               SHFREE( shared->shmpool, entry );
+     if (fusion_skirmish_prevail( &shared->playlist.lock )) {
+          D_FREE( states );
+          return DR_FUSION;
+     }
+
+     /* Add all playbacks to the playlist, deferring the snapshot. */
+     shared->playlist.batch++;
+
+     for (n = 0; n < num; n++) {
+          CoreBatchState *state = &states[n];
+
+          fs_playback_get_status( playbacks[n], &status, NULL );
+
+          state->started = !(status & CPS_PLAYING);
+
+          /* Set the range of a stopped playback before starting it, keeping the previous one for a rollback. */
+          if (state->started && positions && positions[n] >= 0) {
+               fs_playback_get_range( playbacks[n], &state->position, &state->stop );
+
+               fs_playback_set_position( playbacks[n], positions[n] );
+               fs_playback_set_stop( playbacks[n], stops[n] );
+
+               state->moved = true;
+          }
+
+          ret = fs_playback_start( playbacks[n], false );
+          if (ret) {
+               state->started = false;
+               n++;
+               break;
           }
      }
 
+     /* Publish all of them with one snapshot, so that they are mixed from the same cycle on. */
+     if (!ret)
+          ret = fs_core_playlist_publish( shared );
+
+     if (ret) {
+          /* Stop the ones started by this batch again, the entries are retired with a later snapshot. */
+          for (i = 0; i < n; i++) {
+               if (states[i].started)
+                    fs_playback_stop( playbacks[i], false );
+
+               if (states[i].moved) {
+                    fs_playback_set_position( playbacks[i], states[i].position );
+                    fs_playback_set_stop( playbacks[i], states[i].stop );
+               }
+          }
+     }
+     else if (positions) {
+          /* Move playbacks that have been running already, once all of them have been started. */
+          for (i = 0; i < num; i++) {
+               if (!states[i].started && positions[i] >= 0) {
+                    fs_playback_set_position( playbacks[i], positions[i] );
+                    fs_playback_set_stop( playbacks[i], stops[i] );
+               }
+          }
+     }
+
+     shared->playlist.batch--;
+
+     /* Notify new playlist entries to the sound thread. */
+     if (!ret)
+          fusion_skirmish_notify( &shared->playlist.lock );
+
+     fusion_skirmish_dismiss( &shared->playlist.lock );
+
+     D_FREE( states );
+
+     return ret;
+}
+
+DirectResult
+fs_core_stop_playbacks( CoreSound     *core,
+                        CorePlayback **playbacks,
+                        int            num )
+{
+     CoreSoundShared *shared;
+     int              i;
+
+     D_DEBUG_AT( CoreSound_Main, "%s( %p, %d )\n", __FUNCTION__, playbacks, num );
+
+     D_ASSERT( core != NULL );
+     D_ASSERT( core->shared != NULL );
+     D_ASSERT( playbacks != NULL || num == 0 );
+
+     shared = core->shared;
+
+     if (fusion_skirmish_prevail( &shared->playlist.lock ))
+          return DR_FUSION;
+
+     /* Stop all playbacks, each one is left by the sound thread before the next one is stopped. */
+     shared->playlist.batch++;
+
+     for (i = 0; i < num; i++) {
+          if (playbacks[i])
+               fs_playback_stop( playbacks[i], false );
+     }
+
+     shared->playlist.batch--;
+
+     /* Publish the playlist without the stopped playbacks. */
+     fs_core_playlist_publish( shared );
+
+     fusion_skirmish_dismiss( &shared->playlist.lock );
+
      return DR_OK;
 }
 
@@ -595,41 +815,66 @@ fs_core_get_local_volume( CoreSound *core, float *ret_level )
      return DR_OK;
 }
 
-static bool
-volume_callback( FusionObjectPool *pool,
-                 FusionObject     *object,
-                 void             *ctx )
+DirectResult
+fs_core_set_local_volume( CoreSound *core,
+                          float      level )
 {
-     CoreSound *core = ctx;
+     D_ASSERT( core != NULL );
+     D_ASSERT( core->client != NULL );
 
-#if FUSION_BUILD_MULTI
-     if (object->ref.multi.creator != core->fusion_id)
-          return true;
-#endif
+     direct_mutex_lock( &core_sound_lock );
 
-     fs_playback_set_local_volume( (CorePlayback*) object, core->volume );
+     core->volume = level;
+
+     /* Picked up by the sound thread with the next mixing cycle for all playbacks of this client. */
+     core->client->volume = fsf_from_float( level );
+
+     direct_mutex_unlock( &core_sound_lock );
 
-     return true;
+     return DR_OK;
 }
 
-DirectResult
-fs_core_set_local_volume( CoreSound *core,
-                          float      level )
+CoreSoundClient *
+fs_core_client_ref( CoreSound *core )
 {
-     CoreSoundShared *shared;
-
      D_ASSERT( core != NULL );
-     D_ASSERT( core->shared != NULL );
+     D_ASSERT( core->client != NULL );
 
-     shared = core->shared;
+     D_SYNC_ADD_AND_FETCH( &core->client->refs, 1 );
 
-     direct_mutex_lock( &core_sound_lock );
+     return core->client;
+}
 
-     core->volume = level;
+void
+fs_core_client_unref( CoreSoundClient *client )
+{
+     D_ASSERT( client != NULL );
+     D_ASSERT( client->refs > 0 );
 
-     fusion_object_pool_enum( shared->playback_pool, volume_callback, core );
+     if (!D_SYNC_ADD_AND_FETCH( &client->refs, -1 ))
+          SHFREE( client->shmpool, client );
+}
 
-     direct_mutex_unlock( &core_sound_lock );
+/*
+ * Allocate the local client settings.
+ */
+static DirectResult
+fs_core_client_create( CoreSound *core )
+{
+     CoreSoundClient *client;
+
+     D_ASSERT( core != NULL );
+     D_ASSERT( core->shared != NULL );
+
+     client = SHCALLOC( core->shared->shmpool, 1, sizeof(CoreSoundClient) );
+     if (!client)
+          return D_OOSHM();
+
+     client->refs    = 1;
+     client->shmpool = core->shared->shmpool;
+     client->volume  = fsf_from_float( core->volume );
+
+     core->client = client;
 
      return DR_OK;
 }
@@ -706,203 +951,586 @@ fs_core_deinit_check( void *ctx )
 }
 
 /*
- * Mixing buffer uses the following channels mapping:
+ * Output conversion kernels.
+ */
+#define SIMD_NAME generic
+#define SIMD_ATTR
+#include "sound_convert.h"
+#undef SIMD_ATTR
+#undef SIMD_NAME
+
+#if FS_SIMD_X86
+#define SIMD_NAME      sse2
+#define SIMD_ATTR      __attribute__((target("sse2")))
+#define SIMD_U8        fs_simd_u8_sse2
+#define SIMD_U8_LANES  16
+#define SIMD_S16       fs_simd_s16_sse2
+#define SIMD_S16_LANES 8
+#include "sound_convert.h"
+#undef SIMD_S16_LANES
+#undef SIMD_S16
+#undef SIMD_U8_LANES
+#undef SIMD_U8
+#undef SIMD_ATTR
+#undef SIMD_NAME
+
+#define SIMD_NAME      avx2
+#define SIMD_ATTR      __attribute__((target("avx2")))
+#define SIMD_U8        fs_simd_u8_avx2
+#define SIMD_U8_LANES  32
+#define SIMD_S16       fs_simd_s16_avx2
+#define SIMD_S16_LANES 16
+#include "sound_convert.h"
+#undef SIMD_S16_LANES
+#undef SIMD_S16
+#undef SIMD_U8_LANES
+#undef SIMD_U8
+#undef SIMD_ATTR
+#undef SIMD_NAME
+#endif /* FS_SIMD_X86 */
+
+typedef void (*SoundCVFunc) ( const __fsf *src,
+                              u8          *dst,
+                              int          num );
+
+#define CONVERT( simd ) {                                              \
+     convert_to_u8_##simd,  /* FSSF_U8 */                              \
+     convert_to_s16_##simd, /* FSSF_S16 */                             \
+     convert_to_s24_##simd, /* FSSF_S24 */                             \
+     convert_to_s32_##simd, /* FSSF_S32 */                             \
+     convert_to_f32_##simd  /* FSSF_FLOAT */                           \
+}
+
+static const SoundCVFunc CONVERT[FS_SIMD_NUM][FS_NUM_SAMPLEFORMATS] = {
+     CONVERT( generic ), /* FS_SIMD_GENERIC */
+#if FS_SIMD_X86
+     CONVERT( sse2 ),    /* FS_SIMD_SSE2 */
+     CONVERT( avx2 )     /* FS_SIMD_AVX2 */
+#endif
+};
+
+/*
+ * The mixing buffer has one plane for each of the following channels present in the device mode:
  *   1. (L)eft
  *   2. (R)ight
- *   3. (C)enter
- *   4. (R)ear (L)eft
- *   5. (R)ear (R)ight
- *   6. (S)ubwoofer (aka LFE)
+ *   3. (C)enter, otherwise folded into (L)eft and (R)ight by the mixing kernels
+ *   4. (R)ear (L)eft, otherwise mapped to (L)eft
+ *   5. (R)ear (R)ight, otherwise mapped to (R)ight
+ *   6. (S)ubwoofer (aka LFE), otherwise dropped
+ *
+ * Planes are aligned to FS_MIX_PLANE_ALIGN bytes and padded to a multiple of it. A mono device uses both front planes,
+ * a device with a single rear channel both rear planes, which are averaged on output.
+ */
+#define FS_MIX_PLANE_ALIGN 64
+#define FS_MIX_ALIGN( v )  (((v) + FS_MIX_PLANE_ALIGN - 1) & ~(FS_MIX_PLANE_ALIGN - 1))
+
+static DirectResult
+fs_core_alloc_mixing( FSChannelMode   mode,
+                      int             frames,
+                      void          **ret_buffer,
+                      __fsf          *ret_planes[6] )
+{
+     int    num   = 2;
+     int    pitch = FS_MIX_ALIGN( frames * sizeof(__fsf) ) / sizeof(__fsf);
+     __fsf *base;
+
+     if (FS_MODE_HAS_CENTER( mode ))
+          num++;
+
+     if (FS_MODE_NUM_REARS( mode ))
+          num += 2;
+
+     if (FS_MODE_HAS_LFE( mode ))
+          num++;
+
+     *ret_buffer = D_CALLOC( 1, num * pitch * sizeof(__fsf) + FS_MIX_PLANE_ALIGN - 1 );
+     if (!*ret_buffer)
+          return D_OOM();
+
+     base = (__fsf*) FS_MIX_ALIGN( (unsigned long) *ret_buffer );
+
+     num = 0;
+
+     ret_planes[0] = base + pitch * num++;
+     ret_planes[1] = base + pitch * num++;
+     ret_planes[2] = FS_MODE_HAS_CENTER( mode ) ? base + pitch * num++ : NULL;
+
+     if (FS_MODE_NUM_REARS( mode )) {
+          ret_planes[3] = base + pitch * num++;
+          ret_planes[4] = base + pitch * num++;
+     }
+     else {
+          ret_planes[3] = ret_planes[0];
+          ret_planes[4] = ret_planes[1];
+     }
+
+     ret_planes[5] = FS_MODE_HAS_LFE( mode ) ? base + pitch * num++ : NULL;
+
+     return DR_OK;
+}
+
+/*
+ * Get the planes for each output channel, with a second plane to be averaged with the first one or -1.
+ */
+static void
+fs_core_output_planes( FSChannelMode mode,
+                       int           ret_planes[6][2] )
+{
+     int channels = FS_CHANNELS_FOR_MODE( mode );
+     int c;
+
+     for (c = 0; c < 6; c++) {
+          ret_planes[c][0] = -1;
+          ret_planes[c][1] = -1;
+     }
+
+     if (channels == 1) {
+          ret_planes[0][0] = 0;
+          ret_planes[0][1] = 1;
+          return;
+     }
+
+     c = 0;
+
+     ret_planes[c++][0] = 0;
+
+     if (FS_MODE_HAS_CENTER( mode ))
+          ret_planes[c++][0] = 2;
+
+     ret_planes[c++][0] = 1;
+
+     if (FS_MODE_NUM_REARS( mode ) == 1) {
+          ret_planes[c][0]   = 3;
+          ret_planes[c++][1] = 4;
+     }
+     else if (FS_MODE_NUM_REARS( mode ) == 2) {
+          ret_planes[c++][0] = 3;
+          ret_planes[c++][0] = 4;
+     }
+
+     /* FSCM_STEREO31 is encoded with three channels. */
+     if (FS_MODE_HAS_LFE( mode ) && c < channels)
+          ret_planes[c++][0] = 5;
+}
+
+/*
+ * Clear the first 'frames' of the planes in the mask, planes mapped to others being skipped.
+ */
+static void
+fs_core_clear_mixing( __fsf        **mixing,
+                      unsigned int   planes,
+                      int            frames )
+{
+     int c;
+
+     for (c = 0; c < 6; c++) {
+          if (!(planes & (1 << c)) || !mixing[c])
+               continue;
+
+          if ((c == 3 || c == 4) && mixing[c] == mixing[c-3])
+               continue;
+
+          memset( mixing[c], 0, frames * sizeof(__fsf) );
+     }
+}
+
+/*
+ * Add the first 'frames' of the planes in the mask to the destination planes, clearing the source planes. Vectors
+ * may cover the padding of the planes, which is always zero.
+ */
+static void
+fs_core_reduce_mixing( __fsf        **dest,
+                       __fsf        **mixing,
+                       unsigned int   planes,
+                       int            frames )
+{
+     int c, i;
+
+     for (c = 0; c < 6; c++) {
+          __fsf_v8 *d;
+          __fsf_v8 *s;
+
+          if (!(planes & (1 << c)) || !mixing[c])
+               continue;
+
+          if ((c == 3 || c == 4) && mixing[c] == mixing[c-3])
+               continue;
+
+          d = (__fsf_v8*) dest[c];
+          s = (__fsf_v8*) mixing[c];
+
+          for (i = 0; i < (frames + 7) / 8; i++) {
+               d[i] += s[i];
+               s[i]  = (__fsf_v8) {};
+          }
+     }
+}
+
+/*
+ * The playlist is published to the sound thread as snapshots, so that adding or removing playbacks never waits for a
+ * mixing cycle and the sound thread never waits for a client. Snapshots are written with the playlist lock held into
+ * one of three buffers which is neither the current nor the active one, and published by switching the current one.
+ * Removed entries are kept until the active snapshot is one published without them.
+ *
+ * Release removed entries which are not part of the active snapshot anymore, the playlist being locked.
+ */
+static void
+fs_core_playlist_reclaim( CoreSoundShared *shared )
+{
+     CorePlaylistEntry *entry, *next;
+     unsigned int       generation;
+
+     __sync_synchronize();
+
+     generation = shared->playlist.snapshots[shared->playlist.active].generation;
+
+     direct_list_foreach_safe (entry, next, shared->playlist.retired) {
+          if ((int) (generation - entry->generation) >= 0) {
+               direct_list_remove( &shared->playlist.retired, &entry->link );
+
+               entry->retired = false;
+
+               fs_playback_unlink( &entry->playback );
+          }
+     }
+}
+
+/*
+ * Publish the playlist as a new snapshot, the playlist being locked.
  */
-#if FS_MAX_CHANNELS == 6
-# define FS_MIX_OUTPUT_LOOP( BODY ) {                                        \
-     int n;                                                                  \
-     switch (mode) {                                                         \
-          case FSCM_MONO:                                                    \
-               for (n = count; n; n--) {                                     \
-                    register __fsf s;                                        \
-                    const int      c = 0;                                    \
-                    s = src[c] + src[1] + src[2] + src[2] + src[3] + src[4]; \
-                    s = fsf_shr( s, 1 );                                     \
-                    BODY                                                     \
-                    src += FS_MAX_CHANNELS;                                  \
-               }                                                             \
-               break;                                                        \
-          case FSCM_STEREO:                                                  \
-               for (n = count; n; n--) {                                     \
-                    register __fsf s;                                        \
-                    int            c;                                        \
-                    c = 0;                                                   \
-                    s = src[c] + src[2] + src[3];                            \
-                    BODY                                                     \
-                    c = 1;                                                   \
-                    s = src[c] + src[2] + src[4];                            \
-                    BODY                                                     \
-                    src += FS_MAX_CHANNELS;                                  \
-               }                                                             \
-               break;                                                        \
-          case FSCM_STEREO21:                                                \
-          case FSCM_STEREO30:                                                \
-          case FSCM_STEREO31:                                                \
-               for (n = count; n; n--) {                                     \
-                    register __fsf s;                                        \
-                    int            c;                                        \
-                    if (FS_MODE_HAS_CENTER( mode )) {                        \
-                         c = 0;                                              \
-                         s = src[c] + src[3];                                \
-                         BODY                                                \
-                         c = 2;                                              \
-                         s = src[c];                                         \
-                         BODY                                                \
-                         c = 1;                                              \
-                         s = src[c] + src[4];                                \
-                         BODY                                                \
-                    }                                                        \
-                    else {                                                   \
-                         c = 0;                                              \
-                         s = src[c] + src[2] + src[3];                       \
-                         BODY                                                \
-                         c = 1;                                              \
-                         s = src[c] + src[2] + src[4];                       \
-                         BODY                                                \
-                    }                                                        \
-                    if (FS_MODE_HAS_LFE( mode )) {                           \
-                         c = 5;                                              \
-                         s = src[c];                                         \
-                         BODY                                                \
-                    }                                                        \
-                    src += FS_MAX_CHANNELS;                                  \
-               }                                                             \
-               break;                                                        \
-          case FSCM_SURROUND30:                                              \
-          case FSCM_SURROUND31:                                              \
-          case FSCM_SURROUND40_2F2R:                                         \
-          case FSCM_SURROUND41_2F2R:                                         \
-          case FSCM_SURROUND40_3F1R:                                         \
-          case FSCM_SURROUND41_3F1R:                                         \
-          case FSCM_SURROUND50:                                              \
-               for (n = count; n; n--) {                                     \
-                    register __fsf s;                                        \
-                    int            c;                                        \
-                    if (FS_MODE_HAS_CENTER( mode )) {                        \
-                         c = 0;                                              \
-                         s = src[c];                                         \
-                         BODY                                                \
-                         c = 2;                                              \
-                         s = src[c];                                         \
-                         BODY                                                \
-                         c = 1;                                              \
-                         s = src[c];                                         \
-                         BODY                                                \
-                    }                                                        \
-                    else {                                                   \
-                         c = 0;                                              \
-                         s = src[c] + src[2];                                \
-                         BODY                                                \
-                         c = 1;                                              \
-                         s = src[c] + src[2];                                \
-                         BODY                                                \
-                    }                                                        \
-                    if (FS_MODE_NUM_REARS( mode ) == 1) {                    \
-                         c = 3;                                              \
-                         s = fsf_shr( src[c] + src[c+1], 1 );                \
-                         BODY                                                \
-                    }                                                        \
-                    else {                                                   \
-                         c = 3;                                              \
-                         s = src[c];                                         \
-                         BODY                                                \
-                         c = 4;                                              \
-                         s = src[c];                                         \
-                         BODY                                                \
-                    }                                                        \
-                    if (FS_MODE_HAS_LFE( mode )) {                           \
-                         c = 5;                                              \
-                         s = src[c];                                         \
-                         BODY                                                \
-                    }                                                        \
-                    src += FS_MAX_CHANNELS;                                  \
-               }                                                             \
-               break;                                                        \
-          case FSCM_SURROUND51:                                              \
-               for (n = count; n; n--) {                                     \
-                    register __fsf s;                                        \
-                    int            c;                                        \
-                    c = 0;                                                   \
-                    s = src[c];                                              \
-                    BODY                                                     \
-                    c = 2;                                                   \
-                    s = src[c];                                              \
-                    BODY                                                     \
-                    c = 1;                                                   \
-                    s = src[c];                                              \
-                    BODY                                                     \
-                    c = 3;                                                   \
-                    s = src[c];                                              \
-                    BODY                                                     \
-                    c = 4;                                                   \
-                    s = src[c];                                              \
-                    BODY                                                     \
-                    c = 5;                                                   \
-                    s = src[c];                                              \
-                    BODY                                                     \
-                    src += FS_MAX_CHANNELS;                                  \
-               }                                                             \
-               break;                                                        \
-          default:                                                           \
-               D_BUG( "unexpected channel mode" );                           \
-               break;                                                        \
-     }                                                                       \
+static DirectResult
+fs_core_playlist_publish( CoreSoundShared *shared )
+{
+     CorePlaylistSnapshot *snapshot;
+     CorePlaylistEntry    *entry, *next;
+     int                   index;
+     int                   num = 0;
+
+     /* Pick a snapshot neither published nor used by the sound thread. */
+     __sync_synchronize();
+
+     for (index = 0; index < 3; index++) {
+          if (index != shared->playlist.current && index != shared->playlist.active)
+               break;
+     }
+
+     D_ASSERT( index < 3 );
+
+     snapshot = &shared->playlist.snapshots[index];
+
+     direct_list_foreach (entry, shared->playlist.entries) {
+          if (!entry->finished)
+               num++;
+     }
+
+     if (num > snapshot->size) {
+          CorePlaylistEntry **entries;
+          int                 size = MAX( num, snapshot->size * 2 );
+
+          entries = SHMALLOC( shared->shmpool, size * sizeof(CorePlaylistEntry*) );
+          if (!entries)
+               return D_OOSHM();
+
+          if (snapshot->entries)
+               SHFREE( shared->shmpool, snapshot->entries );
+
+          snapshot->entries = entries;
+          snapshot->size    = size;
+     }
+
+     /* Fill the snapshot, retiring finished entries. */
+     snapshot->generation = ++shared->playlist.generation;
+     snapshot->num        = 0;
+
+     direct_list_foreach_safe (entry, next, shared->playlist.entries) {
+          if (entry->finished) {
+               direct_list_remove( &shared->playlist.entries, &entry->link );
+
+               entry->retired    = true;
+               entry->generation = snapshot->generation;
+
+               direct_list_prepend( &shared->playlist.retired, &entry->link );
+          }
+          else
+               snapshot->entries[snapshot->num++] = entry;
+     }
+
+     /* Publish it. */
+     __sync_synchronize();
+
+     shared->playlist.current = index;
+
+     fs_core_playlist_reclaim( shared );
+
+     return DR_OK;
 }
-#else /* FS_MAX_CHANNELS == 2 */
-# define FS_MIX_OUTPUT_LOOP( BODY ) {                                        \
-     int n;                                                                  \
-     if (mode == FSCM_MONO) {                                                \
-          for (n = count; n; n--) {                                          \
-               register __fsf s;                                             \
-               const int      c = 0;                                         \
-               s = fsf_shr( src[c] + src[c+1], 1 );                          \
-               BODY                                                          \
-               src += FS_MAX_CHANNELS;                                       \
-          }                                                                  \
-     }                                                                       \
-     else {                                                                  \
-          for (n = count; n; n--) {                                          \
-               register __fsf s;                                             \
-               int            c;                                             \
-               c = 0;                                                        \
-               s = src[c];                                                   \
-               BODY                                                          \
-               c = 1;                                                        \
-               s = src[c];                                                   \
-               BODY                                                          \
-               src += FS_MAX_CHANNELS;                                       \
-          }                                                                  \
-     }                                                                       \
+
+/*
+ * Return the current snapshot, marking it as active. The sound thread is the only reader.
+ */
+static CorePlaylistSnapshot *
+fs_core_playlist_snapshot( CoreSoundShared *shared )
+{
+     int index;
+
+     do {
+          index = shared->playlist.current;
+
+          shared->playlist.active = index;
+
+          __sync_synchronize();
+     } while (index != shared->playlist.current);
+
+     return &shared->playlist.snapshots[index];
+}
+
+/*
+ * Mix a share of the jobs of the current cycle. In deterministic mode, each mixer gets a fixed range of the playlist,
+ * otherwise jobs are taken one after another by whichever mixer is ready.
+ */
+static void
+fs_core_mix_jobs( CoreSound     *core,
+                  __fsf        **mixing,
+                  int            index,
+                  int           *ret_mixed,
+                  unsigned int  *ret_dirty )
+{
+     CoreSoundShared *shared = core->shared;
+     int              mixed  = 0;
+     unsigned int     dirty  = 0;
+     int              i, last;
+
+     if (fs_config->mix_deterministic) {
+          i    = core->mix_num * index / (core->num_mixers + 1);
+          last = core->mix_num * (index + 1) / (core->num_mixers + 1);
+     }
+     else {
+          i    = D_SYNC_ADD_AND_FETCH( &core->mix_next, 1 ) - 1;
+          last = core->mix_num;
+     }
+
+     while (i < last) {
+          CoreSoundMixJob *job     = &core->mix_jobs[i];
+          int              samples = 0;
+          unsigned int     planes  = 0;
+
+          job->ret = fs_playback_mixto( job->entry->playback, mixing, shared->config.rate, shared->config.mode,
+                                        shared->config.buffersize, shared->soft_volume, &samples, &planes );
+
+          if (samples > mixed)
+               mixed = samples;
+
+          dirty |= planes;
+
+          if (fs_config->mix_deterministic)
+               i++;
+          else
+               i = D_SYNC_ADD_AND_FETCH( &core->mix_next, 1 ) - 1;
+     }
+
+     *ret_mixed = mixed;
+     *ret_dirty = dirty;
+}
+
+static void *
+fs_mix_thread( DirectThread *thread,
+               void         *arg )
+{
+     CoreSoundMixer *mixer = arg;
+     CoreSound      *core  = mixer->core;
+     unsigned int    cycle = 0;
+
+     while (true) {
+          /* Wait for the next cycle. */
+          direct_mutex_lock( &core->mix_lock );
+
+          while (core->mix_cycle == cycle && !core->shutdown)
+               direct_waitqueue_wait( &core->mix_start, &core->mix_lock );
+
+          cycle = core->mix_cycle;
+
+          direct_mutex_unlock( &core->mix_lock );
+
+          if (core->shutdown)
+               break;
+
+          fs_core_mix_jobs( core, mixer->planes, mixer->index, &mixer->mixed, &mixer->dirty );
+
+          /* Report completion to the sound thread. */
+          direct_mutex_lock( &core->mix_lock );
+
+          if (!--core->mix_pending)
+               direct_waitqueue_signal( &core->mix_done );
+
+          direct_mutex_unlock( &core->mix_lock );
+     }
+
+     return NULL;
+}
+
+static void
+fs_core_start_mixers( CoreSound *core )
+{
+     int i;
+
+     for (i = 0; i < core->num_mixers; i++) {
+          CoreSoundMixer *mixer = &core->mixers[i];
+          char            name[16];
+
+          snprintf( name, sizeof(name), "Sound Mixer %d", mixer->index );
+
+          mixer->thread = direct_thread_create( DTT_OUTPUT, fs_mix_thread, mixer, name );
+     }
+}
+
+static void
+fs_core_stop_mixers( CoreSound *core )
+{
+     int i;
+
+     direct_mutex_lock( &core->mix_lock );
+     direct_waitqueue_broadcast( &core->mix_start );
+     direct_mutex_unlock( &core->mix_lock );
+
+     for (i = 0; i < core->num_mixers; i++) {
+          CoreSoundMixer *mixer = &core->mixers[i];
+
+          if (mixer->thread) {
+               direct_thread_join( mixer->thread );
+               direct_thread_destroy( mixer->thread );
+               mixer->thread = NULL;
+          }
+     }
+}
+
+/*
+ * Mix the entries of a playlist snapshot using the mixing threads, returning whether playbacks ended.
+ */
+static void
+fs_core_mix_parallel( CoreSound             *core,
+                      CorePlaylistSnapshot  *snapshot,
+                      int                   *ret_mixed,
+                      unsigned int          *ret_dirty,
+                      bool                  *ret_finished )
+{
+     int           mixed;
+     unsigned int  dirty;
+     bool          finished = false;
+     int           i;
+
+     /* Collect the jobs of this cycle. */
+     core->mix_num  = 0;
+     core->mix_next = 0;
+
+     for (i = 0; i < snapshot->num; i++) {
+          CorePlaylistEntry *entry = snapshot->entries[i];
+
+          if (entry->finished)
+               continue;
+
+          if (core->mix_num == core->mix_size) {
+               CoreSoundMixJob *jobs = D_REALLOC( core->mix_jobs, (core->mix_size + 64) * sizeof(CoreSoundMixJob) );
+
+               if (!jobs) {
+                    D_OOM();
+                    break;
+               }
+
+               core->mix_jobs  = jobs;
+               core->mix_size += 64;
+          }
+
+          core->mix_jobs[core->mix_num].entry = entry;
+          core->mix_jobs[core->mix_num].ret   = DR_OK;
+          core->mix_num++;
+     }
+
+     /* Start the mixing threads. */
+     direct_mutex_lock( &core->mix_lock );
+
+     core->mix_pending = core->num_mixers;
+     core->mix_cycle++;
+
+     direct_waitqueue_broadcast( &core->mix_start );
+
+     direct_mutex_unlock( &core->mix_lock );
+
+     /* Mix the share of the sound thread. */
+     fs_core_mix_jobs( core, core->mixing_planes, 0, &mixed, &dirty );
+
+     /* Wait for the mixing threads. */
+     direct_mutex_lock( &core->mix_lock );
+
+     while (core->mix_pending)
+          direct_waitqueue_wait( &core->mix_done, &core->mix_lock );
+
+     direct_mutex_unlock( &core->mix_lock );
+
+     /* Add the results in a fixed order. */
+     for (i = 0; i < core->num_mixers; i++) {
+          CoreSoundMixer *mixer = &core->mixers[i];
+
+          fs_core_reduce_mixing( core->mixing_planes, mixer->planes, mixer->dirty, mixer->mixed );
+
+          if (mixer->mixed > mixed)
+               mixed = mixer->mixed;
+
+          dirty |= mixer->dirty;
+     }
+
+     /* Check for ended playbacks, their entries have been marked as finished. */
+     for (i = 0; i < core->mix_num; i++) {
+          if (core->mix_jobs[i].ret)
+               finished = true;
+     }
+
+     *ret_mixed    = mixed;
+     *ret_dirty    = dirty;
+     *ret_finished = finished;
 }
-#endif /* FS_MAX_CHANNELS */
 
 static void *
 fs_sound_thread( DirectThread *thread,
                  void         *arg )
 {
-     CoreSound       *core   = arg;
-     CoreSoundShared *shared = core->shared;
-     __fsf           *mixing = core->mixing_buffer;
-     FSChannelMode    mode   = shared->config.mode;
+     CoreSound       *core     = arg;
+     CoreSoundShared *shared   = core->shared;
+     __fsf          **mixing   = core->mixing_planes;
+     __fsf           *output   = core->output_buffer;
+     FSChannelMode    mode     = shared->config.mode;
+     int              channels = FS_CHANNELS_FOR_MODE( mode );
+     int              bits     = 0;
+     SoundCVFunc      convert;
+     int              outputs[6][2];
+     int              mixed    = 0;
+     unsigned int     dirty    = 0;
+     bool             pending  = false; /* entries of ended playbacks are still to be removed from the playlist */
+
+     fs_core_output_planes( mode, outputs );
 
      fsf_dither_profiles( dither, FS_MAX_CHANNELS );
 
+     /* Select the output conversion, dithering only applies to 8 and 16 bit formats. */
+     convert = CONVERT[fs_simd_level()][FS_SAMPLEFORMAT_INDEX( shared->config.format )];
+
+     if (fs_config->dither) {
+          if (shared->config.format == FSSF_U8)
+               bits = 8;
+          else if (shared->config.format == FSSF_S16)
+               bits = 16;
+     }
+
      while (!core->shutdown) {
-          int                delay;
-          int                i;
-          CorePlaylistEntry *entry, *next;
-          __fsf             *src    = mixing;
-          __fsf              l_min  = FSF_MAX;
-          __fsf              l_max  = FSF_MIN;
-          __fsf              r_min  = FSF_MAX;
-          __fsf              r_max  = FSF_MIN;
-          int                length = 0;
+          int                   delay;
+          int                   i;
+          CorePlaylistSnapshot *snapshot;
+          bool                  finished = false;
+          int                   done     = 0;
+          __fsf                 l_min    = FSF_MAX;
+          __fsf                 l_max    = FSF_MIN;
+          __fsf                 r_min    = FSF_MAX;
+          __fsf                 r_max    = FSF_MIN;
+          int                   length   = 0;
 
           direct_thread_testcancel( thread );
 
@@ -910,69 +1538,99 @@ fs_sound_thread( DirectThread *thread,
 
           shared->output_delay = delay * 1000 / shared->config.rate;
 
-          /* Clear mixing buffer. */
-          memset( mixing, 0, shared->config.buffersize * FS_MAX_CHANNELS * sizeof(__fsf) );
+          /* Clear the part of the mixing buffer written in the previous cycle. */
+          fs_core_clear_mixing( mixing, dirty, mixed );
 
-          /* Iterate through running playbacks, mixing them together. */
-          fusion_skirmish_prevail( &shared->playlist.lock );
+          mixed = 0;
+          dirty = 0;
 
-          if (!shared->playlist.entries) {
+          /* Take the current playlist snapshot, waiting for a playback to be added if it's empty. */
+          snapshot = fs_core_playlist_snapshot( shared );
+
+          if (!snapshot->num) {
                shared->master_feedback_left  = 0;
                shared->master_feedback_right = 0;
 
-               if (fusion_skirmish_wait( &shared->playlist.lock, delay ? 1 : 0 )) {
-                    fusion_skirmish_dismiss( &shared->playlist.lock );
-                    continue;
-               }
+               fusion_skirmish_prevail( &shared->playlist.lock );
+
+               fs_core_playlist_reclaim( shared );
+
+               if (!shared->playlist.snapshots[shared->playlist.current].num)
+                    fusion_skirmish_wait( &shared->playlist.lock, delay ? 1 : 0 );
+
+               fusion_skirmish_dismiss( &shared->playlist.lock );
+               continue;
           }
 
-          direct_list_foreach_safe (entry, next, shared->playlist.entries) {
-               DirectResult  ret;
-               int           samples;
+          /* Iterate through running playbacks, mixing them together. */
+          if (core->num_mixers && snapshot->num > 1) {
+               fs_core_mix_parallel( core, snapshot, &length, &dirty, &finished );
+          }
+          else {
+               for (i = 0; i < snapshot->num; i++) {
+                    CorePlaylistEntry *entry   = snapshot->entries[i];
+                    int                samples = 0;
+                    unsigned int       planes  = 0;
+
+                    if (entry->finished)
+                         continue;
 
-               ret = fs_playback_mixto( entry->playback, mixing, shared->config.rate, mode,
-                                        shared->config.buffersize, shared->soft_volume, &samples );
-               if (ret) {
-                    direct_list_remove( &shared->playlist.entries, &entry->link );
+                    if (fs_playback_mixto( entry->playback, mixing, shared->config.rate, mode,
+                                           shared->config.buffersize, shared->soft_volume, &samples, &planes )) {
+                         finished = true;
+                    }
 
-                    fs_playback_unlink( &entry->playback );
+                    if (samples > length)
+                         length = samples;
 
-                    SHFREE( shared->shmpool, entry );
+                    dirty |= planes;
                }
+          }
 
-               if (samples > length)
-                    length = samples;
+          if (finished)
+               pending = true;
+
+          /*
+           * Remove entries of ended playbacks and release removed ones, unless a client holds the playlist lock, which
+           * is retried with the following cycles. Wait for the lock if nothing has been mixed, the snapshot only has
+           * entries of ended playbacks then.
+           */
+          if (pending || shared->playlist.retired) {
+               DirectResult ret = length ? fusion_skirmish_swoop( &shared->playlist.lock ) :
+                                           fusion_skirmish_prevail( &shared->playlist.lock );
+
+               if (ret == DR_OK) {
+                    if (pending) {
+                         if (fs_core_playlist_publish( shared ) == DR_OK)
+                              pending = false;
+                    }
+                    else
+                         fs_core_playlist_reclaim( shared );
+
+                    fusion_skirmish_dismiss( &shared->playlist.lock );
+               }
           }
 
-          fusion_skirmish_dismiss( &shared->playlist.lock );
+          mixed = length;
 
           /* Calculate master feedback. */
-          if (FS_CHANNELS_FOR_MODE( mode ) == 1) {
-               for (i = 0; i < length; i++) {
-                    if (mixing[i] < l_min)
-                         l_min = mixing[i];
+          for (i = 0; i < length; i++) {
+               if (mixing[0][i] < l_min)
+                    l_min = mixing[0][i];
 
-                    if (mixing[i] > l_max)
-                         l_max = mixing[i];
-               }
-
-               r_min = l_min;
-               r_max = l_max;
-          }
-          else {
-               for (i = 0; i < length * FS_CHANNELS_FOR_MODE( mode ); i += FS_CHANNELS_FOR_MODE( mode )) {
-                    if (mixing[i] < l_min)
-                         l_min = mixing[i];
+               if (mixing[0][i] > l_max)
+                    l_max = mixing[0][i];
 
-                    if (mixing[i] > l_max)
-                         l_max = mixing[i];
+               if (mixing[1][i] < r_min)
+                    r_min = mixing[1][i];
 
-                    if (mixing[i+1] < r_min)
-                         r_min = mixing[i];
+               if (mixing[1][i] > r_max)
+                    r_max = mixing[1][i];
+          }
 
-                    if (mixing[i+1] > r_max)
-                         r_max = mixing[i];
-               }
+          if (channels == 1) {
+               r_min = l_min;
+               r_max = l_max;
           }
 
           shared->master_feedback_left  = l_max - l_min;
@@ -981,8 +1639,10 @@ fs_sound_thread( DirectThread *thread,
           /* Loop on samples. */
           while (length) {
                u8           *dst;
+               __fsf        *out;
                unsigned int  avail;
                unsigned int  count;
+               int           c;
 
                /* Get access to the output buffer. */
                if (fs_device_get_buffer( core->device, &dst, &avail ))
@@ -990,77 +1650,49 @@ fs_sound_thread( DirectThread *thread,
 
                count = MIN( avail, length );
 
-               /* Convert mixing buffer to output format, clipping each sample. */
-               switch (shared->config.format) {
-                    case FSSF_U8:
-                         FS_MIX_OUTPUT_LOOP(
-                              if (fs_config->dither)
-                                   s = fsf_dither( s, 8, dither[c] );
-                              s = fsf_clip( s );
-                              *dst++ = fsf_to_u8( s );
-                         )
-                         break;
+               /* Interleave the mixing buffer planes to the output channels, silence for planes not written. */
+               for (c = 0; c < channels; c++) {
+                    int a = outputs[c][0];
+                    int b = outputs[c][1];
 
-                    case FSSF_S16:
-                         FS_MIX_OUTPUT_LOOP(
-                              if (fs_config->dither)
-                                   s = fsf_dither( s, 16, dither[c] );
-                              s = fsf_clip( s );
-                              *((u16*)dst) = fsf_to_s16( s );
-                              dst += 2;
-                         )
-                         break;
+                    out = output + c;
 
-                    case FSSF_S24:
-#ifdef WORDS_BIGENDIAN
-                         FS_MIX_OUTPUT_LOOP( {
-                              int d;
-                              s = fsf_clip( s );
-                              d = fsf_to_s24( s );
-                              dst[0] = d >> 16;
-                              dst[1] = d >>  8;
-                              dst[2] = d;
-                              dst += 3;
-                         } )
-#else
-                         FS_MIX_OUTPUT_LOOP( {
-                              int d;
-                              s = fsf_clip( s );
-                              d = fsf_to_s24( s );
-                              dst[0] = d;
-                              dst[1] = d >>  8;
-                              dst[2] = d >> 16;
-                              dst += 3;
-                         } )
-#endif
-                         break;
+                    if (!(dirty & ((1 << a) | (b < 0 ? 0 : 1 << b)))) {
+                         for (i = 0; i < count; i++, out += channels)
+                              *out = 0;
+                    }
+                    else if (b >= 0) {
+                         const __fsf *pa = mixing[a] + done;
+                         const __fsf *pb = mixing[b] + done;
 
-                    case FSSF_S32:
-                         FS_MIX_OUTPUT_LOOP(
-                              s = fsf_clip( s );
-                              *((u32*)dst) = fsf_to_s32( s );
-                              dst += 4;
-                         )
-                         break;
+                         for (i = 0; i < count; i++, out += channels)
+                              *out = fsf_shr( pa[i] + pb[i], 1 );
+                    }
+                    else {
+                         const __fsf *pa = mixing[a] + done;
 
-                    case FSSF_FLOAT:
-                         FS_MIX_OUTPUT_LOOP(
-                              s = fsf_clip( s );
-                              *((float*)dst) = fsf_to_float( s );
-                              dst += 4;
-                         )
-                         break;
+                         for (i = 0; i < count; i++, out += channels)
+                              *out = pa[i];
+                    }
+               }
 
-                    default:
-                         D_BUG( "unexpected sample format" );
-                         break;
+               /* Apply dithering. */
+               if (bits) {
+                    for (i = 0, out = output; i < count; i++) {
+                         for (c = 0; c < channels; c++, out++)
+                              *out = fsf_dither( *out, bits, dither[c] );
+                    }
                }
 
+               /* Convert to output format, clipping each sample. */
+               convert( output, dst, count * channels );
+
                /* Commit output buffer. */
                fs_device_commit_buffer( core->device, count );
 
                /* Update parameters. */
                length -= count;
+               done   += count;
           }
      }
 
@@ -1185,6 +1817,7 @@ static DirectResult
 fs_core_initialize( CoreSound *core )
 {
      DirectResult     ret;
+     int              i;
      CoreSoundShared *shared;
 
      D_ASSERT( core != NULL );
@@ -1202,6 +1835,11 @@ fs_core_initialize( CoreSound *core )
      if (shared->config.buffersize > 65535)
           shared->config.buffersize = 65535;
 
+     /* Allocate the local client settings. */
+     ret = fs_core_client_create( core );
+     if (ret)
+          return ret;
+
      /* Open output device. */
      ret = fs_device_initialize( core, &shared->config, &core->device );
      if (ret)
@@ -1226,13 +1864,51 @@ fs_core_initialize( CoreSound *core )
      fusion_skirmish_init( &shared->call_lock, "FusionSound Call", core->world );
 
      /* Allocate mixing buffer. */
-     core->mixing_buffer = D_MALLOC( shared->config.buffersize * FS_MAX_CHANNELS * sizeof(__fsf) );
-     if (!core->mixing_buffer)
+     ret = fs_core_alloc_mixing( shared->config.mode, shared->config.buffersize,
+                                 &core->mixing_buffer, core->mixing_planes );
+     if (ret)
+          return ret;
+
+     /* Allocate mixing buffers of the mixing threads. */
+     direct_mutex_init( &core->mix_lock );
+     direct_waitqueue_init( &core->mix_start );
+     direct_waitqueue_init( &core->mix_done );
+
+     if (fs_config->mixthreads > 1) {
+          core->mixers = D_CALLOC( fs_config->mixthreads - 1, sizeof(CoreSoundMixer) );
+          if (!core->mixers)
+               return D_OOM();
+
+          for (i = 0; i < fs_config->mixthreads - 1; i++) {
+               CoreSoundMixer *mixer = &core->mixers[i];
+
+               mixer->core  = core;
+               mixer->index = i + 1;
+
+               ret = fs_core_alloc_mixing( shared->config.mode, shared->config.buffersize,
+                                           &mixer->buffer, mixer->planes );
+               if (ret)
+                    return ret;
+
+               core->num_mixers++;
+          }
+     }
+
+     /* Allocate output buffer. */
+     core->output_buffer = D_MALLOC( shared->config.buffersize * FS_CHANNELS_FOR_MODE( shared->config.mode ) *
+                                     sizeof(__fsf) );
+     if (!core->output_buffer)
           return D_OOM();
 
      /* Initialize software volume level. */
      shared->soft_volume = FSF_ONE;
 
+     /* Build sinc filter coefficients. */
+     fs_sinc_init();
+
+     /* Start mixing threads. */
+     fs_core_start_mixers( core );
+
      /* Start sound mixer thread. */
      core->sound_thread = direct_thread_create( DTT_OUTPUT, fs_sound_thread, core, "Sound Mixer" );
 
@@ -1245,6 +1921,7 @@ fs_core_shutdown( CoreSound *core,
 {
      CorePlaylistEntry *entry, *next;
      CoreSoundShared   *shared;
+     int                i;
 
      D_ASSERT( core != NULL );
      D_ASSERT( core->shared != NULL );
@@ -1264,6 +1941,9 @@ fs_core_shutdown( CoreSound *core,
           direct_thread_destroy( core->sound_thread );
      }
 
+     /* Stop mixing threads. */
+     fs_core_stop_mixers( core );
+
      if (!local) {
           /* Close output device. */
           fs_device_shutdown( core->device );
@@ -1272,9 +1952,20 @@ fs_core_shutdown( CoreSound *core,
           fusion_skirmish_prevail( &shared->playlist.lock );
 
           direct_list_foreach_safe (entry, next, shared->playlist.entries) {
+               direct_list_remove( &shared->playlist.entries, &entry->link );
+
+               fs_playback_unlink( &entry->playback );
+          }
+
+          direct_list_foreach_safe (entry, next, shared->playlist.retired) {
+               direct_list_remove( &shared->playlist.retired, &entry->link );
+
                fs_playback_unlink( &entry->playback );
+          }
 
-               SHFREE( shared->shmpool, entry );
+          for (i = 0; i < 3; i++) {
+               if (shared->playlist.snapshots[i].entries)
+                    SHFREE( shared->shmpool, shared->playlist.snapshots[i].entries );
           }
 
           /* Destroy call lock. */
@@ -1293,6 +1984,23 @@ fs_core_shutdown( CoreSound *core,
           fusion_skirmish_destroy( &shared->playlist.lock );
      }
 
+     /* Release output buffer. */
+     D_FREE( core->output_buffer );
+
+     /* Release mixing buffers of the mixing threads. */
+     for (i = 0; i < core->num_mixers; i++)
+          D_FREE( core->mixers[i].buffer );
+
+     if (core->mixers)
+          D_FREE( core->mixers );
+
+     if (core->mix_jobs)
+          D_FREE( core->mix_jobs );
+
+     direct_waitqueue_deinit( &core->mix_done );
+     direct_waitqueue_deinit( &core->mix_start );
+     direct_mutex_deinit( &core->mix_lock );
+
      /* Release mixing buffer. */
      D_FREE( core->mixing_buffer );
 
@@ -1302,13 +2010,24 @@ fs_core_shutdown( CoreSound *core,
 static DirectResult
 fs_core_leave( CoreSound *core )
 {
+     D_ASSERT( core != NULL );
+
+     /* Release the local client settings, unless still referenced by playbacks. */
+     if (core->client) {
+          fs_core_client_unref( core->client );
+          core->client = NULL;
+     }
+
      return DR_OK;
 }
 
 static DirectResult
 fs_core_join( CoreSound *core )
 {
-     return DR_OK;
+     D_ASSERT( core != NULL );
+
+     /* Allocate the local client settings. */
+     return fs_core_client_create( core );
 }
 
 /**********************************************************************************************************************/
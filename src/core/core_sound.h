@@ -20,6 +20,7 @@
 #define __CORE__CORE_SOUND_H__
 
 #include <core/coretypes_sound.h>
+#include <core/fs_types.h>
 #include <fusion/object.h>
 
 /**********************************************************************************************************************/
@@ -53,7 +54,18 @@ DirectResult           fs_core_enum_playbacks     ( CoreSound             *core,
 
 /*
  * Playback list management.
- */
+ *
+ * Each playback embeds its playlist entry, which references the playback while it's part of the playlist and until
+ * no snapshot mixed by the sound thread contains it anymore.
+ */
+struct __FS_CorePlaylistEntry {
+     DirectLink    link;
+     CorePlayback *playback;   /* linked while listed or retired */
+     bool          finished;   /* not to be mixed anymore, removed with the next snapshot */
+     bool          retired;    /* removed from the playlist, possibly still in a snapshot */
+     unsigned int  generation; /* generation of the first snapshot not containing the entry */
+};
+
 DirectResult           fs_core_playlist_lock      ( CoreSound             *core );
 
 DirectResult           fs_core_playlist_unlock    ( CoreSound             *core );
@@ -64,6 +76,22 @@ DirectResult           fs_core_add_playback       ( CoreSound             *core,
 DirectResult           fs_core_remove_playback    ( CoreSound             *core,
                                                     CorePlayback          *playback );
 
+/*
+ * Start or stop a number of playbacks with the playlist locked once. Started playbacks are published to the sound
+ * thread with one snapshot and begin on the same sample, if one of them can't be started, none is playing afterwards.
+ * Playbacks are started at 'positions' up to 'stops' (if given), a negative position keeps the current ones. The range
+ * of playbacks started by the batch is restored on failure, running ones are only moved once all have been started.
+ */
+DirectResult           fs_core_start_playbacks    ( CoreSound             *core,
+                                                    CorePlayback         **playbacks,
+                                                    const int             *positions,
+                                                    const int             *stops,
+                                                    int                    num );
+
+DirectResult           fs_core_stop_playbacks     ( CoreSound             *core,
+                                                    CorePlayback         **playbacks,
+                                                    int                    num );
+
 /*
  * Returns the amount of audio data buffered by the device in ms.
  */
@@ -101,6 +129,23 @@ DirectResult           fs_core_get_master_volume  ( CoreSound             *core,
 DirectResult           fs_core_set_master_volume  ( CoreSound             *core,
                                                     float                  level );
 
+/*
+ * Settings of a client process in shared memory, read by the sound thread when mixing the client's playbacks. Each
+ * playback references the settings of its creator, which may terminate while the playback is still running.
+ */
+struct __FS_CoreSoundClient {
+     int                  refs;
+     FusionSHMPoolShared *shmpool;
+     __fsf                volume;  /* local volume level */
+};
+
+/*
+ * Returns the settings of the local client with an additional reference.
+ */
+CoreSoundClient       *fs_core_client_ref         ( CoreSound             *core );
+
+void                   fs_core_client_unref       ( CoreSoundClient       *client );
+
 /*
  * Returns the local volume.
  */
@@ -108,7 +153,7 @@ DirectResult           fs_core_get_local_volume   ( CoreSound             *core,
                                                     float                 *ret_level );
 
 /*
- * Sets the local volume.
+ * Sets the local volume, applied to all playbacks of the local client from the next mixing cycle on.
  */
 DirectResult           fs_core_set_local_volume   ( CoreSound             *core,
                                                     float                  level );
@@ -25,8 +25,10 @@
 /**********************************************************************************************************************/
 
 typedef struct __FS_CorePlayback          CorePlayback;
+typedef struct __FS_CorePlaylistEntry     CorePlaylistEntry;
 typedef struct __FS_CoreSound             CoreSound;
 typedef struct __FS_CoreSoundBuffer       CoreSoundBuffer;
+typedef struct __FS_CoreSoundClient       CoreSoundClient;
 typedef struct __FS_CoreSoundDevice       CoreSoundDevice;
 typedef struct __FS_CoreSoundDeviceConfig CoreSoundDeviceConfig;
 
@@ -20,30 +20,90 @@
 #include <core/playback.h>
 #include <core/sound_buffer.h>
 #include <core/sound_device.h>
+#include <direct/atomic.h>
+#include <direct/memcpy.h>
+#include <misc/sound_conf.h>
 
 D_DEBUG_DOMAIN( CoreSound_Playback, "CoreSound/Playback", "FusionSound Core Playback" );
 
 /**********************************************************************************************************************/
 
-struct __FS_CorePlayback {
-     FusionObject     object;
-
-     FusionSkirmish   lock;
+typedef enum {
+     CPC_STOP,
+     CPC_POSITION,
+     CPC_LEVELS,
+     CPC_PITCH,
+     CPC_QUALITY,
+     CPC_NUM
+} CorePlaybackChange;
 
-     CoreSound       *core;
-     CoreSoundBuffer *buffer;
-     bool             notify;
+/*
+ * Latest parameter values set by clients, each one replacing a previous change not yet applied.
+ */
+typedef struct {
+     unsigned int             seq;             /* incremented before and after each change, odd while being changed */
+     unsigned int             serial[CPC_NUM]; /* incremented by each change of the parameter */
+     int                      stop;
+     int                      position;
+     int                      pitch;
+     FSPlaybackQuality        quality;
+     __fsf                    levels[6];
+} CorePlaybackChanges;
 
-     bool             disabled;  /* playback disabled */
-     bool             running;   /* playback position */
-     int              position;  /* playback position */
-     int              stop;      /* stop position */
-     int              pitch;     /* multiplier for sample rate */
+/*
+ * Playback state published for readers not taking the lock.
+ */
+typedef struct {
+     unsigned int             seq;       /* incremented before and after each update, odd while being updated */
+     bool                     running;
+     int                      position;
+     int                      stop;
+     unsigned int             played;
+} CorePlaybackState;
 
-     __fsf            center;    /* downmixing level for center channel */
-     __fsf            rear;      /* downmixing level for rear channel */
-     __fsf            levels[6]; /* multipliers for channels  */
-     __fsf            volume;    /* local volume level */
+struct __FS_CorePlayback {
+     FusionObject         object;
+
+     FusionSkirmish       lock;
+
+     CoreSound           *core;
+     CoreSoundBuffer     *buffer;
+     bool                 notify;
+
+     bool                 disabled;  /* playback disabled */
+     bool                 running;   /* playback position */
+     int                  position;  /* playback position */
+     int                  stop;      /* stop position */
+     int                  pitch;     /* multiplier for sample rate */
+     FSPlaybackQuality    quality;   /* interpolation quality */
+
+     __fsf                center;    /* downmixing level for center channel */
+     __fsf                rear;      /* downmixing level for rear channel */
+     __fsf                levels[6]; /* multipliers for channels  */
+     unsigned int         generation; /* incremented by each change of the levels */
+     CoreSoundClient     *client;    /* settings of the creator, e.g. local volume level */
+
+     struct {
+          __fsf           levels[6];  /* levels with master and local volume applied, used for mixing */
+          unsigned int    generation; /* generation of the levels they have been computed from */
+          __fsf           master;     /* master volume level they have been computed for */
+          __fsf           local;      /* local volume level they have been computed for */
+          bool            unity;      /* all levels used by the channel mode of the buffer are at unity */
+     } gains;
+
+     CorePlaybackChanges  changes;   /* parameter changes made by clients */
+     unsigned int         synced;    /* sequence number of the changes applied last */
+     unsigned int         applied[CPC_NUM]; /* serials of the changes applied last */
+     int                  mixing;    /* set by the sound thread while mixing the playback */
+
+     unsigned int         played;    /* number of frames played in total */
+     unsigned int         notified;  /* number of frames played when CPNF_ADVANCE was sent last */
+     unsigned int         watermark; /* number of frames played at which CPNF_ADVANCE is sent */
+     bool                 armed;     /* watermark set by a client */
+
+     CorePlaybackState    status;    /* copy of the playback state readable without locking */
+
+     CorePlaylistEntry    entry;
 };
 
 /**********************************************************************************************************************/
@@ -65,6 +125,9 @@ playback_destructor( FusionObject *object,
 
      fs_buffer_unlink( &playback->buffer );
 
+     if (playback->client)
+          fs_core_client_unref( playback->client );
+
      fusion_skirmish_destroy( &playback->lock );
 
      /* Destroy the object. */
@@ -87,7 +150,6 @@ fs_playback_create( CoreSound        *core,
                     bool              notify,
                     CorePlayback    **ret_playback )
 {
-     float         volume;
      CorePlayback *playback;
 
      D_ASSERT( buffer != NULL );
@@ -108,9 +170,10 @@ fs_playback_create( CoreSound        *core,
 
      fusion_skirmish_init( &playback->lock, "FusionSound Playback", fs_core_world( core ) );
 
-     playback->core   = core;
-     playback->notify = notify;
-     playback->pitch  = FS_PITCH_ONE;
+     playback->core    = core;
+     playback->notify  = notify;
+     playback->pitch   = FS_PITCH_ONE;
+     playback->quality = fs_config->quality;
 
      /* Set default downmixing levels. */
      fs_playback_set_downmix( playback, DOWNMIX_LEVEL_3DB, DOWNMIX_LEVEL_3DB );
@@ -122,10 +185,10 @@ fs_playback_create( CoreSound        *core,
      playback->levels[3] = playback->rear;
      playback->levels[4] = playback->rear;
      playback->levels[5] = FSF_ONE;
+     playback->generation = 1;
 
-     /* Get local volume level. */
-     fs_core_get_local_volume( core, &volume );
-     playback->volume = fsf_from_float( volume );
+     /* Use local volume level of the creator. */
+     playback->client = fs_core_client_ref( core );
 
      /* Activate the object. */
      fusion_object_activate( &playback->object );
@@ -159,9 +222,69 @@ fs_playback_enable( CorePlayback *playback )
      return DR_OK;
 }
 
+/*
+ * Publish the playback state to readers of fs_playback_get_status(). Updates are made by the sound thread and by
+ * clients, which take the sequence counter (making it odd) to exclude each other.
+ */
+static void
+fs_playback_publish( CorePlayback *playback )
+{
+     unsigned int seq;
+
+     for (;;) {
+          seq = playback->status.seq;
+
+          if (!(seq & 1) && D_SYNC_BOOL_COMPARE_AND_SWAP( &playback->status.seq, seq, seq + 1 ))
+               break;
+
+          __sync_synchronize();
+     }
+
+     playback->status.running  = playback->running;
+     playback->status.position = playback->position;
+     playback->status.stop     = playback->stop;
+     playback->status.played   = playback->played;
+
+     __sync_synchronize();
+
+     playback->status.seq = seq + 2;
+}
+
+/*
+ * Read the published playback state, retrying if it has been updated meanwhile.
+ */
+static void
+fs_playback_read( CorePlayback      *playback,
+                  CorePlaybackState *ret_state )
+{
+     unsigned int seq;
+
+     do {
+          for (;;) {
+               seq = playback->status.seq;
+
+               if (!(seq & 1))
+                    break;
+
+               __sync_synchronize();
+          }
+
+          __sync_synchronize();
+
+          *ret_state = playback->status;
+
+          __sync_synchronize();
+     } while (playback->status.seq != seq);
+}
+
+/*
+ * Notify listeners with values captured while owning the playback, which may have been restarted meanwhile.
+ */
 static void
 fs_playback_notify( CorePlayback                  *playback,
                     CorePlaybackNotificationFlags  flags,
+                    int                            pos,
+                    int                            stop,
                     int                            num )
 {
      CorePlaybackNotification notification;
@@ -172,29 +295,195 @@ fs_playback_notify( CorePlayback                  *playback,
 
      D_DEBUG_AT( CoreSound_Playback, "%s( %p )\n", __FUNCTION__, playback );
 
-     if (flags & CPNF_START)
-          playback->running = true;
-
-     if (flags & CPNF_STOP)
-          playback->running = false;
-
      if (!playback->notify)
           return;
 
      notification.flags    = flags;
      notification.playback = playback;
-     notification.pos      = playback->position;
-     notification.stop     = playback->running ? playback->stop : playback->position;
+     notification.pos      = pos;
+     notification.stop     = stop;
      notification.num      = num;
 
      fs_playback_dispatch( playback, &notification, NULL );
 }
 
+/*
+ * Parameters used for mixing are owned by the sound thread while the playback is running and by clients otherwise.
+ * Clients store the latest value of each parameter with the playback lock held, never waiting for the sound thread,
+ * which applies them before mixing the playback without taking the lock. While the playback is not running, clients
+ * apply them directly, once the sound thread has left fs_playback_mixto().
+ */
+static void
+fs_playback_apply( CorePlayback *playback )
+{
+     CorePlaybackChanges changes;
+     unsigned int        seq;
+
+     __sync_synchronize();
+
+     seq = playback->changes.seq;
+
+     /* Nothing changed, or a change is being made right now and is applied with the next cycle. */
+     if (seq == playback->synced || (seq & 1))
+          return;
+
+     __sync_synchronize();
+
+     changes = playback->changes;
+
+     __sync_synchronize();
+
+     /* Retry with the next cycle if the changes have been modified while copying them. */
+     if (playback->changes.seq != seq)
+          return;
+
+     if (changes.serial[CPC_STOP] != playback->applied[CPC_STOP])
+          playback->stop = changes.stop;
+
+     if (changes.serial[CPC_POSITION] != playback->applied[CPC_POSITION])
+          playback->position = changes.position;
+
+     if (changes.serial[CPC_LEVELS] != playback->applied[CPC_LEVELS]) {
+          direct_memcpy( playback->levels, changes.levels, sizeof(playback->levels) );
+          playback->generation++;
+     }
+
+     if (changes.serial[CPC_PITCH] != playback->applied[CPC_PITCH])
+          playback->pitch = changes.pitch;
+
+     if (changes.serial[CPC_QUALITY] != playback->applied[CPC_QUALITY])
+          playback->quality = changes.quality;
+
+     direct_memcpy( playback->applied, changes.serial, sizeof(playback->applied) );
+
+     playback->synced = seq;
+}
+
+/*
+ * Wait for the sound thread to leave the playback and apply pending changes, the playback being locked and not
+ * running.
+ */
+static void
+fs_playback_sync( CorePlayback *playback )
+{
+     __sync_synchronize();
+
+     while (playback->mixing) {
+          usleep( 100 );
+
+          __sync_synchronize();
+     }
+
+     fs_playback_apply( playback );
+
+     fs_playback_publish( playback );
+}
+
+/*
+ * Take the playback from the sound thread, waiting for it to leave fs_playback_mixto(), the playback being locked.
+ */
+static void
+fs_playback_take( CorePlayback *playback )
+{
+     while (!D_SYNC_BOOL_COMPARE_AND_SWAP( &playback->mixing, 0, 1 ))
+          usleep( 100 );
+}
+
+/*
+ * Release the playback to the sound thread.
+ */
+static void
+fs_playback_release( CorePlayback *playback )
+{
+     __sync_synchronize();
+
+     playback->mixing = 0;
+}
+
+/*
+ * Begin a change, the playback being locked.
+ */
+static void
+fs_playback_change_begin( CorePlayback *playback )
+{
+     playback->changes.seq++;
+
+     __sync_synchronize();
+}
+
+/*
+ * Finish a change, applying it directly if the playback is not running.
+ */
+static void
+fs_playback_change_end( CorePlayback *playback )
+{
+     __sync_synchronize();
+
+     playback->changes.seq++;
+
+     __sync_synchronize();
+
+     if (!playback->running)
+          fs_playback_sync( playback );
+}
+
+/*
+ * Convert levels for mixing, applying downmixing levels, the playback being locked.
+ */
+static void
+fs_playback_levels( CorePlayback *playback,
+                    const float   levels[6],
+                    __fsf         ret_levels[6] )
+{
+     int i;
+
+     for (i = 0; i < 6; i++)
+          ret_levels[i] = fsf_from_float( levels[i] );
+
+     /* Apply downmixing levels. */
+     if (playback->center != FSF_ONE) {
+          ret_levels[2] = fsf_mul( ret_levels[2], playback->center );
+     }
+
+     if (playback->rear != FSF_ONE) {
+          ret_levels[3] = fsf_mul( ret_levels[3], playback->rear );
+          ret_levels[4] = fsf_mul( ret_levels[4], playback->rear );
+     }
+}
+
+/*
+ * Compute the effective levels for mixing, owned by the sound thread like the levels.
+ */
+static void
+fs_playback_gains( CorePlayback *playback,
+                   __fsf         master,
+                   __fsf         local )
+{
+     int   i;
+     __fsf volume = fsf_mul( master, local );
+
+     D_DEBUG_AT( CoreSound_Playback, "%s( %p )\n", __FUNCTION__, playback );
+
+     if (volume != FSF_ONE) {
+          for (i = 0; i < 6; i++)
+               playback->gains.levels[i] = fsf_mul( playback->levels[i], volume );
+     }
+     else
+          direct_memcpy( playback->gains.levels, playback->levels, sizeof(playback->gains.levels) );
+
+     playback->gains.generation = playback->generation;
+     playback->gains.master     = master;
+     playback->gains.local      = local;
+     playback->gains.unity      = fs_buffer_unity_levels( playback->buffer, playback->gains.levels );
+}
+
 DirectResult
 fs_playback_start( CorePlayback *playback,
                    bool          enable )
 {
      DirectResult ret = DR_OK;
+     int          pos;
+     int          stop;
 
      D_ASSERT( playback != NULL );
      D_ASSERT( playback->buffer != NULL );
@@ -221,11 +510,22 @@ fs_playback_start( CorePlayback *playback,
                ret = DR_TEMPUNAVAIL;
           }
           else {
+               /* Apply pending changes before handing the playback to the sound thread. */
+               fs_playback_sync( playback );
+
+               pos  = playback->position;
+               stop = playback->stop;
+
                ret = fs_core_add_playback( playback->core, playback );
 
                /* Notify listeners about the beginning of the playback. */
-               if (ret == DR_OK)
-                    fs_playback_notify( playback, CPNF_START, 0 );
+               if (ret == DR_OK) {
+                    playback->running = true;
+
+                    fs_playback_publish( playback );
+
+                    fs_playback_notify( playback, CPNF_START, pos, stop, 0 );
+               }
           }
      }
 
@@ -242,6 +542,8 @@ DirectResult
 fs_playback_stop( CorePlayback *playback,
                   bool          disable )
 {
+     bool stopped = false;
+
      D_ASSERT( playback != NULL );
 
      D_DEBUG_AT( CoreSound_Playback, "%s( %p )\n", __FUNCTION__, playback );
@@ -256,14 +558,28 @@ fs_playback_stop( CorePlayback *playback,
           return DR_FUSION;
      }
 
-     /* Stop the playback if it's running. */
+     /* Take back the playback from the sound thread, which may be ending it itself. */
+     fs_playback_take( playback );
+
+     /* Stop the playback if it's still running. */
      if (playback->running) {
           fs_core_remove_playback( playback->core, playback );
 
-          /* Notify listeners about the end of the playback. */
-          fs_playback_notify( playback, CPNF_STOP, 0 );
+          playback->running = false;
+
+          fs_playback_apply( playback );
+
+          fs_playback_publish( playback );
+
+          stopped = true;
      }
 
+     fs_playback_release( playback );
+
+     /* Notify listeners about the end of the playback. */
+     if (stopped)
+          fs_playback_notify( playback, CPNF_STOP, playback->position, playback->position, 0 );
+
      /* If the playback is enabled, play will start. */
      if (disable)
           playback->disabled = true;
@@ -291,7 +607,12 @@ fs_playback_set_stop( CorePlayback *playback,
           return DR_FUSION;
 
      /* Adjust stop position. */
-     playback->stop = stop;
+     fs_playback_change_begin( playback );
+
+     playback->changes.stop = stop;
+     playback->changes.serial[CPC_STOP]++;
+
+     fs_playback_change_end( playback );
 
      /* Unlock playback. */
      fusion_skirmish_dismiss( &playback->lock );
@@ -314,7 +635,12 @@ fs_playback_set_position( CorePlayback *playback,
           return DR_FUSION;
 
      /* Adjust the playback position. */
-     playback->position = position;
+     fs_playback_change_begin( playback );
+
+     playback->changes.position = position;
+     playback->changes.serial[CPC_POSITION]++;
+
+     fs_playback_change_end( playback );
 
      /* Unlock playback. */
      fusion_skirmish_dismiss( &playback->lock );
@@ -365,8 +691,6 @@ DirectResult
 fs_playback_set_volume( CorePlayback *playback,
                         float         levels[6] )
 {
-     int i;
-
      D_ASSERT( playback != NULL );
      D_ASSERT( levels[0] >= 0.0f );
      D_ASSERT( levels[0] <= 64.0f );
@@ -380,18 +704,12 @@ fs_playback_set_volume( CorePlayback *playback,
           return DR_FUSION;
 
      /* Adjust volume. */
-     for (i = 0; i < 6; i++)
-          playback->levels[i] = fsf_from_float( levels[i] );
+     fs_playback_change_begin( playback );
 
-     /* Apply downmixing levels. */
-     if (playback->center != FSF_ONE) {
-          playback->levels[2] = fsf_mul( playback->levels[2], playback->center );
-     }
+     fs_playback_levels( playback, levels, playback->changes.levels );
+     playback->changes.serial[CPC_LEVELS]++;
 
-     if (playback->rear != FSF_ONE) {
-          playback->levels[3] = fsf_mul( playback->levels[3], playback->rear );
-          playback->levels[4] = fsf_mul( playback->levels[4], playback->rear );
-     }
+     fs_playback_change_end( playback );
 
      /* Unlock playback. */
      fusion_skirmish_dismiss( &playback->lock );
@@ -400,12 +718,12 @@ fs_playback_set_volume( CorePlayback *playback,
 }
 
 DirectResult
-fs_playback_set_local_volume( CorePlayback *playback,
-                              float         level )
+fs_playback_set_pitch( CorePlayback *playback,
+                       int           pitch )
 {
      D_ASSERT( playback != NULL );
-     D_ASSERT( level >= 0.0f );
-     D_ASSERT( level <= 1.0f );
+     D_ASSERT( pitch >= -64 * FS_PITCH_ONE );
+     D_ASSERT( pitch <= +64 * FS_PITCH_ONE );
 
      D_DEBUG_AT( CoreSound_Playback, "%s( %p )\n", __FUNCTION__, playback );
 
@@ -413,8 +731,13 @@ fs_playback_set_local_volume( CorePlayback *playback,
      if (fusion_skirmish_prevail( &playback->lock ))
           return DR_FUSION;
 
-     /* Set local volume level. */
-     playback->volume = fsf_from_float( level );
+     /* Adjust pitch. */
+     fs_playback_change_begin( playback );
+
+     playback->changes.pitch = pitch;
+     playback->changes.serial[CPC_PITCH]++;
+
+     fs_playback_change_end( playback );
 
      /* Unlock playback. */
      fusion_skirmish_dismiss( &playback->lock );
@@ -423,10 +746,15 @@ fs_playback_set_local_volume( CorePlayback *playback,
 }
 
 DirectResult
-fs_playback_set_pitch( CorePlayback *playback,
-                       int           pitch )
+fs_playback_set_params( CorePlayback *playback,
+                        float         levels[6],
+                        int           pitch )
 {
      D_ASSERT( playback != NULL );
+     D_ASSERT( levels[0] >= 0.0f );
+     D_ASSERT( levels[0] <= 64.0f );
+     D_ASSERT( levels[1] >= 0.0f );
+     D_ASSERT( levels[1] <= 64.0f );
      D_ASSERT( pitch >= -64 * FS_PITCH_ONE );
      D_ASSERT( pitch <= +64 * FS_PITCH_ONE );
 
@@ -436,8 +764,43 @@ fs_playback_set_pitch( CorePlayback *playback,
      if (fusion_skirmish_prevail( &playback->lock ))
           return DR_FUSION;
 
-     /* Adjust pitch. */
-     playback->pitch = pitch;
+     /* Adjust volume and pitch with one change. */
+     fs_playback_change_begin( playback );
+
+     fs_playback_levels( playback, levels, playback->changes.levels );
+     playback->changes.serial[CPC_LEVELS]++;
+
+     playback->changes.pitch = pitch;
+     playback->changes.serial[CPC_PITCH]++;
+
+     fs_playback_change_end( playback );
+
+     /* Unlock playback. */
+     fusion_skirmish_dismiss( &playback->lock );
+
+     return DR_OK;
+}
+
+DirectResult
+fs_playback_set_quality( CorePlayback      *playback,
+                         FSPlaybackQuality  quality )
+{
+     D_ASSERT( playback != NULL );
+     D_ASSERT( quality >= FSPQ_NONE && quality <= FSPQ_SINC );
+
+     D_DEBUG_AT( CoreSound_Playback, "%s( %p, %d )\n", __FUNCTION__, playback, quality );
+
+     /* Lock playback. */
+     if (fusion_skirmish_prevail( &playback->lock ))
+          return DR_FUSION;
+
+     /* Adjust interpolation quality. */
+     fs_playback_change_begin( playback );
+
+     playback->changes.quality = quality;
+     playback->changes.serial[CPC_QUALITY]++;
+
+     fs_playback_change_end( playback );
 
      /* Unlock playback. */
      fusion_skirmish_dismiss( &playback->lock );
@@ -450,22 +813,23 @@ fs_playback_get_status( CorePlayback       *playback,
                         CorePlaybackStatus *ret_status,
                         int                *ret_position )
 {
+     CorePlaybackState state;
+
      D_ASSERT( playback != NULL );
 
      D_DEBUG_AT( CoreSound_Playback, "%s( %p )\n", __FUNCTION__, playback );
 
-     /* Lock playback. */
-     if (fusion_skirmish_prevail( &playback->lock ))
-          return DR_FUSION;
+     /* Read the published state without locking. */
+     fs_playback_read( playback, &state );
 
      /* Return status. */
      if (ret_status) {
           CorePlaybackStatus status = CPS_NONE;
 
-          if (playback->running) {
+          if (state.running) {
                status |= CPS_PLAYING;
 
-               if (playback->stop < 0)
+               if (state.stop < 0)
                     status |= CPS_LOOPING;
           }
 
@@ -474,28 +838,105 @@ fs_playback_get_status( CorePlayback       *playback,
 
      /* Return position. */
      if (ret_position)
-          *ret_position = playback->position;
+          *ret_position = state.position;
 
-     /* Unlock playback. */
-     fusion_skirmish_dismiss( &playback->lock );
+     return DR_OK;
+}
+
+DirectResult
+fs_playback_get_range( CorePlayback *playback,
+                       int          *ret_position,
+                       int          *ret_stop )
+{
+     CorePlaybackState state;
+
+     D_ASSERT( playback != NULL );
+     D_ASSERT( ret_position != NULL );
+     D_ASSERT( ret_stop != NULL );
+
+     D_DEBUG_AT( CoreSound_Playback, "%s( %p )\n", __FUNCTION__, playback );
+
+     /* Read the published state without locking. */
+     fs_playback_read( playback, &state );
+
+     *ret_position = state.position;
+     *ret_stop     = state.stop;
+
+     return DR_OK;
+}
+
+DirectResult
+fs_playback_get_played( CorePlayback *playback,
+                        unsigned int *ret_played,
+                        int          *ret_position )
+{
+     CorePlaybackState state;
+
+     D_ASSERT( playback != NULL );
+     D_ASSERT( ret_played != NULL );
+
+     D_DEBUG_AT( CoreSound_Playback, "%s( %p )\n", __FUNCTION__, playback );
+
+     /* Read the published state without locking. */
+     fs_playback_read( playback, &state );
+
+     *ret_played = state.played;
+
+     if (ret_position)
+          *ret_position = state.position;
+
+     return DR_OK;
+}
+
+DirectResult
+fs_playback_set_watermark( CorePlayback *playback,
+                           unsigned int  played )
+{
+     D_ASSERT( playback != NULL );
+
+     D_DEBUG_AT( CoreSound_Playback, "%s( %p, %u )\n", __FUNCTION__, playback, played );
+
+     playback->watermark = played;
+
+     __sync_synchronize();
+
+     playback->armed = true;
+
+     return DR_OK;
+}
+
+DirectResult
+fs_playback_clear_watermark( CorePlayback *playback )
+{
+     D_ASSERT( playback != NULL );
+
+     D_DEBUG_AT( CoreSound_Playback, "%s( %p )\n", __FUNCTION__, playback );
+
+     playback->armed = false;
 
      return DR_OK;
 }
 
 DirectResult
 fs_playback_mixto( CorePlayback  *playback,
-                   __fsf         *dest,
+                   __fsf         *dest[6],
                    int            rate,
                    FSChannelMode  mode,
                    int            max_frames,
                    __fsf          volume,
-                   int           *ret_samples )
+                   int           *ret_samples,
+                   unsigned int  *ret_planes )
 {
-     DirectResult  ret;
-     int           i;
-     int           num;
-     int           pos;
-     __fsf        *levels;
+     DirectResult                   ret;
+     int                            num;
+     int                            pos;
+     int                            stop;
+     __fsf                          local;
+     bool                           ring;
+     unsigned int                   written;
+     unsigned int                   read;
+     CorePlaybackNotificationFlags  flags    = CPNF_NONE;
+     int                            advanced = 0;
 
      D_ASSERT( playback != NULL );
      D_ASSERT( playback->buffer != NULL );
@@ -504,35 +945,104 @@ fs_playback_mixto( CorePlayback  *playback,
 
      D_DEBUG_AT( CoreSound_Playback, "%s( %p )\n", __FUNCTION__, playback );
 
-     /* Lock playback. */
-     if (fusion_skirmish_prevail( &playback->lock ))
-          return DR_FUSION;
+     /* Take the playback, unless a client is stopping it or it has been stopped after the playlist snapshot. */
+     if (!D_SYNC_BOOL_COMPARE_AND_SWAP( &playback->mixing, 0, 1 ))
+          return DR_OK;
 
-     /* Set levels. */
-     if (volume != FSF_ONE || playback->volume != FSF_ONE) {
-          levels = alloca( 6 * sizeof(__fsf) );
-          volume = fsf_mul( volume, playback->volume );
-          for (i = 0; i < 6; i++)
-               levels[i] = fsf_mul( playback->levels[i], volume );
+     if (!playback->running) {
+          playback->mixing = 0;
+          return DR_OK;
      }
-     else {
-          levels = playback->levels;
+
+     /* Apply changes made by clients. */
+     fs_playback_apply( playback );
+
+     /* Update the effective levels if the levels or the master or local volume changed. */
+     local = playback->client->volume;
+
+     if (playback->gains.generation != playback->generation ||
+         playback->gains.master != volume || playback->gains.local != local)
+          fs_playback_gains( playback, volume, local );
+
+     /* Let the writer of a ring buffer fill in the frames for this cycle if requested. */
+     fs_buffer_ring_pull( playback->buffer, rate, max_frames, playback->pitch );
+
+     /* Play up to the write index of a ring buffer, staying in the playlist with silence while it's empty. */
+     stop = playback->stop;
+     ring = fs_buffer_ring_get( playback->buffer, &written, &read );
+
+     if (ring) {
+          if (written == read) {
+               *ret_samples = max_frames;
+
+               fs_playback_release( playback );
+               return DR_OK;
+          }
+
+          stop = (playback->position + (int) (written - read)) % fs_buffer_length( playback->buffer );
      }
 
      /* Mix samples. */
-     ret = fs_buffer_mixto( playback->buffer, dest, rate, mode, max_frames, playback->position, playback->stop, levels,
-                            playback->pitch, &pos, &num, ret_samples );
-     if (ret)
-          playback->running = false;
+     ret = fs_buffer_mixto( playback->buffer, dest, rate, mode, max_frames, playback->position, stop,
+                            playback->gains.levels, playback->gains.unity, playback->pitch, playback->quality,
+                            &pos, &num, ret_samples, ret_planes );
 
      /* Set new position. */
-     playback->position = pos;
+     playback->position  = pos;
+     playback->played   += num;
 
-     /* Unlock playback. */
-     fusion_skirmish_dismiss( &playback->lock );
+     /* Hand the mixed frames back to the writer, an underrun at the write index is filled with silence. */
+     if (ring) {
+          fs_buffer_ring_read( playback->buffer, read + num );
+
+          *ret_samples = max_frames;
+
+          ret = DR_OK;
+     }
+
+     /* Hand the playback over to clients at its end, applying changes made in the meantime. */
+     if (ret) {
+          playback->running        = false;
+          playback->entry.finished = true;
 
-     /* Notify listeners about new position in the playback (and a possible end of the playback). */
-     fs_playback_notify( playback, ret ? (CPNF_ADVANCE | CPNF_STOP) : CPNF_ADVANCE, num );
+          fs_playback_apply( playback );
+
+          flags = CPNF_ADVANCE | CPNF_STOP;
+     }
+     else if (playback->armed) {
+          __sync_synchronize();
+
+          /* Coalesce advances until the watermark has been reached. */
+          if ((int) (playback->played - playback->watermark) >= 0)
+               flags = CPNF_ADVANCE;
+     }
+
+     /* Capture the values to notify, clients may restart the playback as soon as it is released. */
+     if (flags) {
+          advanced = playback->played - playback->notified;
+
+          playback->notified = playback->played;
+
+          pos  = playback->position;
+          stop = (flags & CPNF_STOP) ? pos : playback->stop;
+     }
+
+     fs_playback_publish( playback );
+
+     /* Release playback. */
+     fs_playback_release( playback );
+
+     /* Notify listeners about the position in the playback (and a possible end of the playback). */
+     if (flags)
+          fs_playback_notify( playback, flags, pos, stop, advanced );
 
      return ret;
 }
+
+CorePlaylistEntry *
+fs_playback_entry( CorePlayback *playback )
+{
+     D_ASSERT( playback != NULL );
+
+     return &playback->entry;
+}
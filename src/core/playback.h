@@ -37,6 +37,7 @@ typedef enum {
 /**********************************************************************************************************************/
 
 typedef enum {
+     CPNF_NONE    = 0x00000000,
      CPNF_START   = 0x00000001,
      CPNF_STOP    = 0x00000002,
      CPNF_ADVANCE = 0x00000004
@@ -48,7 +49,8 @@ typedef struct {
      int                            pos;    /* Current playback position. */
      int                            stop;   /* Position at which the playback will stop or has stopped.
                                                A negative value indicates looping. */
-     int                            num;    /* Number of samples played (CPNF_ADVANCE) or zero. */
+     int                            num;    /* Number of samples played since the last CPNF_ADVANCE (CPNF_ADVANCE)
+                                               or zero. */
 } CorePlaybackNotification;
 
 /**********************************************************************************************************************/
@@ -91,22 +93,61 @@ DirectResult      fs_playback_set_downmix     ( CorePlayback        *playback,
 DirectResult      fs_playback_set_volume      ( CorePlayback        *playback,
                                                 float                levels[6] );
 
-DirectResult      fs_playback_set_local_volume( CorePlayback        *playback,
-                                                float                level );
-
 DirectResult      fs_playback_set_pitch       ( CorePlayback        *playback,
                                                 int                  pitch );
 
+/*
+ * Set volume levels and pitch at once, locking the playback only once.
+ */
+DirectResult      fs_playback_set_params      ( CorePlayback        *playback,
+                                                float                levels[6],
+                                                int                  pitch );
+
+DirectResult      fs_playback_set_quality     ( CorePlayback        *playback,
+                                                FSPlaybackQuality    quality );
+
+/*
+ * Returns the state published after each mixing cycle and each change by clients, without locking the playback.
+ */
 DirectResult      fs_playback_get_status      ( CorePlayback        *playback,
                                                 CorePlaybackStatus  *ret_status,
                                                 int                 *ret_position );
 
+/*
+ * Returns the position and the stop position, without locking the playback.
+ */
+DirectResult      fs_playback_get_range       ( CorePlayback        *playback,
+                                                int                 *ret_position,
+                                                int                 *ret_stop );
+
+/*
+ * Returns the number of frames played in total and the position, without locking the playback.
+ */
+DirectResult      fs_playback_get_played      ( CorePlayback        *playback,
+                                                unsigned int        *ret_played,
+                                                int                 *ret_position );
+
+/*
+ * CPNF_ADVANCE is only sent along with CPNF_STOP, or once the total number of frames played has reached the
+ * watermark. The watermark stays set until cleared.
+ */
+DirectResult      fs_playback_set_watermark   ( CorePlayback        *playback,
+                                                unsigned int         played );
+
+DirectResult      fs_playback_clear_watermark ( CorePlayback        *playback );
+
+/*
+ * Returns the playlist entry embedded in the playback.
+ */
+CorePlaylistEntry *fs_playback_entry          ( CorePlayback        *playback );
+
 DirectResult      fs_playback_mixto           ( CorePlayback        *playback,
-                                                __fsf               *dest,
+                                                __fsf               *dest[6],
                                                 int                  dest_rate,
                                                 FSChannelMode        dest_mode,
                                                 int                  max_frames,
                                                 __fsf                volume,
-                                                int                 *ret_samples );
+                                                int                 *ret_samples,
+                                                unsigned int        *ret_planes );
 
 #endif
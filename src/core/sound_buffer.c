@@ -20,6 +20,9 @@
 #include <core/core_sound.h>
 #include <core/playback.h>
 #include <core/sound_buffer.h>
+#include <core/sound_simd.h>
+#include <core/sound_sinc.h>
+#include <direct/memcpy.h>
 #include <fusion/shmalloc.h>
 
 D_DEBUG_DOMAIN( CoreSound_Buffer, "CoreSound/Buffer", "FusionSound Core Buffer" );
@@ -35,8 +38,17 @@ struct __FS_CoreSoundBuffer {
      int                  rate;
      int                  bytes;
      void                *data;
+     int                  mirror;   /* frames allocated after the end, see fs_buffer_wrap() */
 
      FusionSHMPoolShared *shmpool;
+
+     struct {
+          bool            enabled;  /* data is handed to the sound thread through the indices */
+          unsigned int    written;  /* number of frames written in total, stored by the writer */
+          unsigned int    read;     /* number of frames mixed in total, stored by the sound thread */
+          bool            pull;     /* frames are requested from the writer while mixing */
+          FusionCall      call;     /* call into the writer to request frames */
+     } ring;
 };
 
 /**********************************************************************************************************************/
@@ -75,6 +87,7 @@ fs_buffer_create( CoreSound        *core,
                   FSChannelMode     mode,
                   FSSampleFormat    format,
                   int               rate,
+                  bool              mirror,
                   CoreSoundBuffer **ret_buffer )
 {
      int                  bytes;
@@ -89,8 +102,8 @@ fs_buffer_create( CoreSound        *core,
      D_ASSERT( rate > 0 );
      D_ASSERT( ret_buffer != NULL );
 
-     D_DEBUG_AT( CoreSound_Buffer, "%s( len %d, mode %08x, fmt %08x, rate %d )\n", __FUNCTION__,
-                 length, mode, format, rate );
+     D_DEBUG_AT( CoreSound_Buffer, "%s( len %d, mode %08x, fmt %08x, rate %d%s )\n", __FUNCTION__,
+                 length, mode, format, rate, mirror ? ", mirrored" : "" );
 
      /* Create the buffer object. */
      buffer = fs_core_create_buffer( core );
@@ -101,13 +114,15 @@ fs_buffer_create( CoreSound        *core,
      channels = FS_CHANNELS_FOR_MODE( mode );
      pool     = fs_core_shmpool( core );
 
-     buffer->data = SHMALLOC( pool, length * bytes * channels );
+     /* A mirrored buffer can be written up to its length from any position, see fs_buffer_wrap(). */
+     buffer->data = SHMALLOC( pool, (mirror ? 2 * length : length) * bytes * channels );
      if (!buffer->data) {
           fusion_object_destroy( &buffer->object );
           return DR_NOLOCALMEMORY;
      }
 
      buffer->length  = length;
+     buffer->mirror  = mirror ? length : 0;
      buffer->mode    = mode;
      buffer->format  = format;
      buffer->rate    = rate;
@@ -136,7 +151,7 @@ fs_buffer_lock( CoreSoundBuffer  *buffer,
      D_ASSERT( pos >= 0 );
      D_ASSERT( pos < buffer->length );
      D_ASSERT( length >= 0 );
-     D_ASSERT( length + pos <= buffer->length );
+     D_ASSERT( length + pos <= buffer->length + buffer->mirror );
      D_ASSERT( ret_data != NULL );
      D_ASSERT( ret_bytes != NULL );
 
@@ -151,6 +166,21 @@ fs_buffer_lock( CoreSoundBuffer  *buffer,
      return DR_OK;
 }
 
+DirectResult
+fs_buffer_wrap( CoreSoundBuffer *buffer,
+                int              length )
+{
+     D_ASSERT( buffer != NULL );
+     D_ASSERT( length >= 0 );
+     D_ASSERT( length <= buffer->mirror );
+
+     D_DEBUG_AT( CoreSound_Buffer, "%s( %p, len %d )\n", __FUNCTION__, buffer, length );
+
+     direct_memcpy( buffer->data, buffer->data + buffer->bytes * buffer->length, buffer->bytes * length );
+
+     return DR_OK;
+}
+
 DirectResult
 fs_buffer_unlock( CoreSoundBuffer *buffer )
 {
@@ -179,6 +209,156 @@ FSChannelMode fs_buffer_mode( CoreSoundBuffer  *buffer )
      return buffer->mode;
 };
 
+int
+fs_buffer_length( CoreSoundBuffer *buffer )
+{
+     D_ASSERT( buffer != NULL );
+
+     return buffer->length;
+}
+
+/*
+ * The ring indices have a single writer each, the stream writing the data and the sound thread mixing it. Each side
+ * stores its index after accessing the data and loads the other index before accessing the data.
+ */
+
+void
+fs_buffer_ring_enable( CoreSoundBuffer *buffer )
+{
+     D_ASSERT( buffer != NULL );
+
+     D_DEBUG_AT( CoreSound_Buffer, "%s( %p )\n", __FUNCTION__, buffer );
+
+     buffer->ring.written = 0;
+     buffer->ring.read    = 0;
+
+     __sync_synchronize();
+
+     buffer->ring.enabled = true;
+}
+
+bool
+fs_buffer_ring_get( CoreSoundBuffer *buffer,
+                    unsigned int    *ret_written,
+                    unsigned int    *ret_read )
+{
+     D_ASSERT( buffer != NULL );
+
+     if (!buffer->ring.enabled)
+          return false;
+
+     /* Load the read index first, it never passes the write index. */
+     if (ret_read)
+          *ret_read = buffer->ring.read;
+
+     __sync_synchronize();
+
+     if (ret_written)
+          *ret_written = buffer->ring.written;
+
+     __sync_synchronize();
+
+     return true;
+}
+
+void
+fs_buffer_ring_write( CoreSoundBuffer *buffer,
+                      unsigned int     written )
+{
+     D_ASSERT( buffer != NULL );
+     D_ASSERT( buffer->ring.enabled );
+
+     __sync_synchronize();
+
+     buffer->ring.written = written;
+}
+
+void
+fs_buffer_ring_read( CoreSoundBuffer *buffer,
+                     unsigned int     read )
+{
+     D_ASSERT( buffer != NULL );
+     D_ASSERT( buffer->ring.enabled );
+
+     __sync_synchronize();
+
+     buffer->ring.read = read;
+}
+
+DirectResult
+fs_buffer_ring_pull_init( CoreSoundBuffer   *buffer,
+                          const FusionWorld *world,
+                          FusionCallHandler  handler,
+                          void              *ctx )
+{
+     DirectResult ret;
+
+     D_ASSERT( buffer != NULL );
+     D_ASSERT( buffer->ring.enabled );
+     D_ASSERT( handler != NULL );
+
+     D_DEBUG_AT( CoreSound_Buffer, "%s( %p )\n", __FUNCTION__, buffer );
+
+     ret = fusion_call_init( &buffer->ring.call, handler, ctx, world );
+     if (ret)
+          return ret;
+
+     __sync_synchronize();
+
+     buffer->ring.pull = true;
+
+     return DR_OK;
+}
+
+void
+fs_buffer_ring_pull_deinit( CoreSoundBuffer *buffer )
+{
+     D_ASSERT( buffer != NULL );
+
+     D_DEBUG_AT( CoreSound_Buffer, "%s( %p )\n", __FUNCTION__, buffer );
+
+     if (!buffer->ring.pull)
+          return;
+
+     buffer->ring.pull = false;
+
+     fusion_call_destroy( &buffer->ring.call );
+}
+
+DirectResult
+fs_buffer_ring_pull( CoreSoundBuffer *buffer,
+                     int              rate,
+                     int              max_frames,
+                     int              pitch )
+{
+     long long inc;
+     int       need;
+     int       avail;
+     int       val;
+
+     D_ASSERT( buffer != NULL );
+     D_ASSERT( rate > 0 );
+     D_ASSERT( max_frames > 0 );
+
+     if (!buffer->ring.pull)
+          return DR_OK;
+
+     /* Number of frames advanced by mixing 'max_frames', as calculated by fs_buffer_mixto(). */
+     inc  = (long long) buffer->rate * ABS( pitch ) / rate;
+     need = MIN( ((long long) max_frames * inc + FS_PITCH_ONE - 1) >> FS_PITCH_BITS, buffer->length );
+
+     __sync_synchronize();
+
+     avail = buffer->ring.written - buffer->ring.read;
+     if (avail >= need)
+          return DR_OK;
+
+     D_DEBUG_AT( CoreSound_Buffer, "%s( %p ) <- requesting %d frames\n", __FUNCTION__, buffer, need - avail );
+
+     /* The writer must not block, there's no timeout. Frames still missing afterwards are mixed as silence. */
+     return fusion_call_execute( &buffer->ring.call, FCEF_NONE, need - avail, NULL, &val );
+}
+
 typedef struct {
 #ifdef WORDS_BIGENDIAN
      s8 c;
@@ -194,7 +374,9 @@ typedef struct {
 #define FORMAT u8
 #define TYPE   u8
 #define FSF_FROM_SRC(s,i) fsf_from_u8(s[i])
+#define FSF_VEC_FROM_SRC(v,V) fsf_vec_from_u8(v,V)
 #include "sound_mix.h"
+#undef  FSF_VEC_FROM_SRC
 #undef  FSF_FROM_SRC
 #undef  TYPE
 #undef  FORMAT
@@ -202,7 +384,9 @@ typedef struct {
 #define FORMAT s16
 #define TYPE   s16
 #define FSF_FROM_SRC(s,i) fsf_from_s16(s[i])
+#define FSF_VEC_FROM_SRC(v,V) fsf_vec_from_s16(v,V)
 #include "sound_mix.h"
+#undef  FSF_VEC_FROM_SRC
 #undef  FSF_FROM_SRC
 #undef  TYPE
 #undef  FORMAT
@@ -218,7 +402,9 @@ typedef struct {
 #define FORMAT s32
 #define TYPE   s32
 #define FSF_FROM_SRC(s,i) fsf_from_s32(s[i])
+#define FSF_VEC_FROM_SRC(v,V) fsf_vec_from_s32(v,V)
 #include "sound_mix.h"
+#undef  FSF_VEC_FROM_SRC
 #undef  FSF_FROM_SRC
 #undef  TYPE
 #undef  FORMAT
@@ -226,123 +412,294 @@ typedef struct {
 #define FORMAT f32
 #define TYPE   float
 #define FSF_FROM_SRC(s,i) fsf_from_float(s[i])
+#define FSF_VEC_FROM_SRC(v,V) fsf_vec_from_float(v,V)
 #include "sound_mix.h"
+#undef  FSF_VEC_FROM_SRC
 #undef  FSF_FROM_SRC
 #undef  TYPE
 #undef  FORMAT
 
-typedef int (*SoundMXFunc) ( CoreSoundBuffer *buffer,
-                             __fsf           *mixing,
-                             FSChannelMode    mode,
-                             long             pos,
-                             long             inc,
-                             long             max,
-                             __fsf            levels[6],
-                             bool             last );
+typedef int (*SoundMXFunc) ( const void *data,
+                             __fsf      *mixing[6],
+                             long        pos,
+                             long        i,
+                             long        inc,
+                             long        max,
+                             __fsf       levels[6],
+                             bool        last );
+
+/*
+ * Kernel table indices besides the vector instruction set and the sample format.
+ */
+#define MIX_FILTER_UNITY    FS_NUM_PLAYBACK_QUALITIES   /* unity pitch, following the interpolation qualities */
+#define MIX_NUM_FILTERS     (FS_NUM_PLAYBACK_QUALITIES + 1)
 
-static const SoundMXFunc MIX_FW[FS_NUM_SAMPLEFORMATS][FS_MAX_CHANNELS] = {
-     {
-          mix_from_u8_mono_fw,   mix_from_u8_stereo_fw,
-#if FS_MAX_CHANNELS > 2
-          mix_from_u8_multi_fw,  mix_from_u8_multi_fw,
-          mix_from_u8_multi_fw,  mix_from_u8_multi_fw
-#endif
-     }, /* FSSF_U8 */
-     {
-          mix_from_s16_mono_fw,  mix_from_s16_stereo_fw,
-#if FS_MAX_CHANNELS > 2
-          mix_from_s16_multi_fw, mix_from_s16_multi_fw,
-          mix_from_s16_multi_fw, mix_from_s16_multi_fw
-#endif
-     }, /* FSSF_S16 */
-     {
-          mix_from_s24_mono_fw,  mix_from_s24_stereo_fw,
-#if FS_MAX_CHANNELS > 2
-          mix_from_s24_multi_fw, mix_from_s24_multi_fw,
-          mix_from_s24_multi_fw, mix_from_s24_multi_fw
-#endif
-     }, /* FSSF_S24 */
-     {
-          mix_from_s32_mono_fw,  mix_from_s32_stereo_fw,
 #if FS_MAX_CHANNELS > 2
-          mix_from_s32_multi_fw, mix_from_s32_multi_fw,
-          mix_from_s32_multi_fw, mix_from_s32_multi_fw
+#define MIX_NUM_LAYOUTS     13                          /* see mix_layout() */
+#else
+#define MIX_NUM_LAYOUTS     2
 #endif
-     }, /* FSSF_S32 */
-     {
-          mix_from_f32_mono_fw,  mix_from_f32_stereo_fw,
+
+/*
+ * Kernels for both directions, both gain variants and both mixing buffer variants.
+ */
+#define MIX_DIRS( format, layout, output, gain, filter ) {                                                 \
+     mix_from_##format##_##layout##_##output##_##gain##_fw_##filter,                                       \
+     mix_from_##format##_##layout##_##output##_##gain##_rw_##filter                                        \
+}
+#define MIX_GAINS( format, layout, output, filter ) {                                                      \
+     MIX_DIRS( format, layout, output, gain,   filter ),                                                   \
+     MIX_DIRS( format, layout, output, nogain, filter )                                                    \
+}
 #if FS_MAX_CHANNELS > 2
-          mix_from_f32_multi_fw, mix_from_f32_multi_fw,
-          mix_from_f32_multi_fw, mix_from_f32_multi_fw
+#define MIX_OUTPUTS( format, layout, filter ) {                                                            \
+     MIX_GAINS( format, layout, lr,  filter ),                                                             \
+     MIX_GAINS( format, layout, lcr, filter )                                                              \
+}
+#else
+#define MIX_OUTPUTS( format, layout, filter ) {                                                            \
+     MIX_GAINS( format, layout, lr,  filter ),                                                             \
+     MIX_GAINS( format, layout, lr,  filter )                                                              \
+}
 #endif
-     }  /* FSSF_FLOAT */
-};
 
-static const SoundMXFunc MIX_RW[FS_NUM_SAMPLEFORMATS][FS_MAX_CHANNELS] = {
-     {
-          mix_from_u8_mono_rw,   mix_from_u8_stereo_rw,
+/*
+ * Kernels for all source channel modes, indexed by mix_layout(). Multichannel sources use the nearest sample
+ * kernels at unity pitch.
+ */
 #if FS_MAX_CHANNELS > 2
-          mix_from_u8_multi_rw,  mix_from_u8_multi_rw,
-          mix_from_u8_multi_rw,  mix_from_u8_multi_rw
+#define MIX_LAYOUTS( format, filter ) {                                                                    \
+     MIX_OUTPUTS( format, mono,            filter ),                                                       \
+     MIX_OUTPUTS( format, stereo,          filter ),                                                       \
+     MIX_OUTPUTS( format, stereo21,        filter ),                                                       \
+     MIX_OUTPUTS( format, surround30,      filter ),                                                       \
+     MIX_OUTPUTS( format, surround31,      filter ),                                                       \
+     MIX_OUTPUTS( format, surround40_2f2r, filter ),                                                       \
+     MIX_OUTPUTS( format, surround41_2f2r, filter ),                                                       \
+     MIX_OUTPUTS( format, stereo30,        filter ),                                                       \
+     MIX_OUTPUTS( format, stereo31,        filter ),                                                       \
+     MIX_OUTPUTS( format, surround40_3f1r, filter ),                                                       \
+     MIX_OUTPUTS( format, surround41_3f1r, filter ),                                                       \
+     MIX_OUTPUTS( format, surround50,      filter ),                                                       \
+     MIX_OUTPUTS( format, surround51,      filter )                                                        \
+}
+#define MIX_UNITY_LAYOUTS( format, simd ) {                                                                \
+     MIX_OUTPUTS( format, mono,            unity_##simd ),                                                 \
+     MIX_OUTPUTS( format, stereo,          unity_##simd ),                                                 \
+     MIX_OUTPUTS( format, stereo21,        none ),                                                         \
+     MIX_OUTPUTS( format, surround30,      none ),                                                         \
+     MIX_OUTPUTS( format, surround31,      none ),                                                         \
+     MIX_OUTPUTS( format, surround40_2f2r, none ),                                                         \
+     MIX_OUTPUTS( format, surround41_2f2r, none ),                                                         \
+     MIX_OUTPUTS( format, stereo30,        none ),                                                         \
+     MIX_OUTPUTS( format, stereo31,        none ),                                                         \
+     MIX_OUTPUTS( format, surround40_3f1r, none ),                                                         \
+     MIX_OUTPUTS( format, surround41_3f1r, none ),                                                         \
+     MIX_OUTPUTS( format, surround50,      none ),                                                         \
+     MIX_OUTPUTS( format, surround51,      none )                                                          \
+}
+#else
+#define MIX_LAYOUTS( format, filter ) {                                                                    \
+     MIX_OUTPUTS( format, mono,            filter ),                                                       \
+     MIX_OUTPUTS( format, stereo,          filter )                                                        \
+}
+#define MIX_UNITY_LAYOUTS( format, simd ) {                                                                \
+     MIX_OUTPUTS( format, mono,            unity_##simd ),                                                 \
+     MIX_OUTPUTS( format, stereo,          unity_##simd )                                                  \
+}
 #endif
-     }, /* FSSF_U8 */
-     {
-          mix_from_s16_mono_rw,  mix_from_s16_stereo_rw,
-#if FS_MAX_CHANNELS > 2
-          mix_from_s16_multi_rw, mix_from_s16_multi_rw,
-          mix_from_s16_multi_rw, mix_from_s16_multi_rw
+
+/*
+ * Kernels for all sample formats, indexed by FS_SAMPLEFORMAT_INDEX().
+ */
+#define MIX_FORMATS( LAYOUTS, filter ) {                                                                   \
+     LAYOUTS( u8,  filter ),                                                                               \
+     LAYOUTS( s16, filter ),                                                                               \
+     LAYOUTS( s24, filter ),                                                                               \
+     LAYOUTS( s32, filter ),                                                                               \
+     LAYOUTS( f32, filter )                                                                                \
+}
+
+/*
+ * SSE2 kernels are only built if the baseline target lacks SSE2.
+ */
+#ifdef __SSE2__
+#define MIX_SSE2            generic
+#define MIX_SINC_SSE2       sinc_generic
+#else
+#define MIX_SSE2            sse2
+#define MIX_SINC_SSE2       sinc_sse2
 #endif
-     }, /* FSSF_S16 */
+
+static const SoundMXFunc MIX[FS_SIMD_NUM][MIX_NUM_FILTERS][FS_NUM_SAMPLEFORMATS][MIX_NUM_LAYOUTS][2][2][2] = {
      {
-          mix_from_s24_mono_rw,  mix_from_s24_stereo_rw,
-#if FS_MAX_CHANNELS > 2
-          mix_from_s24_multi_rw, mix_from_s24_multi_rw,
-          mix_from_s24_multi_rw, mix_from_s24_multi_rw
-#endif
-     }, /* FSSF_S24 */
+          MIX_FORMATS( MIX_LAYOUTS,       none ),           /* FSPQ_NONE */
+          MIX_FORMATS( MIX_LAYOUTS,       linear ),         /* FSPQ_LINEAR */
+          MIX_FORMATS( MIX_LAYOUTS,       cubic ),          /* FSPQ_CUBIC */
+          MIX_FORMATS( MIX_LAYOUTS,       sinc_generic ),   /* FSPQ_SINC */
+          MIX_FORMATS( MIX_UNITY_LAYOUTS, generic )         /* MIX_FILTER_UNITY */
+     }, /* FS_SIMD_GENERIC */
+#if FS_SIMD_X86
      {
-          mix_from_s32_mono_rw,  mix_from_s32_stereo_rw,
-#if FS_MAX_CHANNELS > 2
-          mix_from_s32_multi_rw, mix_from_s32_multi_rw,
-          mix_from_s32_multi_rw, mix_from_s32_multi_rw
-#endif
-     }, /* FSSF_S32 */
+          MIX_FORMATS( MIX_LAYOUTS,       none ),           /* FSPQ_NONE */
+          MIX_FORMATS( MIX_LAYOUTS,       linear ),         /* FSPQ_LINEAR */
+          MIX_FORMATS( MIX_LAYOUTS,       cubic ),          /* FSPQ_CUBIC */
+          MIX_FORMATS( MIX_LAYOUTS,       MIX_SINC_SSE2 ),  /* FSPQ_SINC */
+          MIX_FORMATS( MIX_UNITY_LAYOUTS, MIX_SSE2 )        /* MIX_FILTER_UNITY */
+     }, /* FS_SIMD_SSE2 */
      {
-          mix_from_f32_mono_rw,  mix_from_f32_stereo_rw,
-#if FS_MAX_CHANNELS > 2
-          mix_from_f32_multi_rw, mix_from_f32_multi_rw,
-          mix_from_f32_multi_rw, mix_from_f32_multi_rw
+          MIX_FORMATS( MIX_LAYOUTS,       none ),           /* FSPQ_NONE */
+          MIX_FORMATS( MIX_LAYOUTS,       linear ),         /* FSPQ_LINEAR */
+          MIX_FORMATS( MIX_LAYOUTS,       cubic ),          /* FSPQ_CUBIC */
+          MIX_FORMATS( MIX_LAYOUTS,       sinc_avx2 ),      /* FSPQ_SINC */
+          MIX_FORMATS( MIX_UNITY_LAYOUTS, avx2 )            /* MIX_FILTER_UNITY */
+     }  /* FS_SIMD_AVX2 */
 #endif
-     }  /* FSSF_FLOAT */
 };
 
+/*
+ * Number of frames each interpolation filter reads before and after the frame at the position.
+ */
+static const struct {
+     int before;
+     int after;
+} mix_neighbours[MIX_NUM_FILTERS] = {
+     { 0,                    0 },                       /* FSPQ_NONE */
+     { 0,                    1 },                       /* FSPQ_LINEAR */
+     { 1,                    2 },                       /* FSPQ_CUBIC */
+     { FS_SINC_TAPS / 2 - 1, FS_SINC_TAPS / 2 },        /* FSPQ_SINC */
+     { 0,                    0 }                        /* MIX_FILTER_UNITY */
+};
+
+/* Number of frames mixed from the seam copy besides the neighbours. */
+#define MIX_SEAM_FRAMES     32
+
+/*
+ * Copy 'num' frames starting at frame 'first' (taken modulo the buffer length) to 'dst'.
+ */
+static void
+mix_copy_seam( CoreSoundBuffer *buffer,
+               void            *dst,
+               long             first,
+               int              num )
+{
+     long q = first % buffer->length;
+
+     if (q < 0)
+          q += buffer->length;
+
+     while (num) {
+          int n = MIN( num, buffer->length - q );
+
+          direct_memcpy( dst, buffer->data + q * buffer->bytes, n * buffer->bytes );
+
+          dst += n * buffer->bytes;
+          num -= n;
+          q    = 0;
+     }
+}
+
+/*
+ * Table index of a source channel mode.
+ */
+static inline int
+mix_layout( FSChannelMode mode )
+{
+     if (FS_CHANNELS_FOR_MODE( mode ) == 1)
+          return 0;
+
+     return 1 + FS_MODE_HAS_CENTER( mode ) * 6 + FS_MODE_NUM_REARS( mode ) * 2 + FS_MODE_HAS_LFE( mode );
+}
+
+/*
+ * Check whether all levels used by a source channel mode are at unity.
+ */
+static inline bool
+mix_unity_gain( FSChannelMode  mode,
+                const __fsf   *levels )
+{
+     if (levels[0] != FSF_ONE || levels[1] != FSF_ONE)
+          return false;
+
+     if (FS_MODE_HAS_CENTER( mode ) && levels[2] != FSF_ONE)
+          return false;
+
+     if (FS_MODE_NUM_REARS( mode ) && (levels[3] != FSF_ONE || levels[4] != FSF_ONE))
+          return false;
+
+     if (FS_MODE_HAS_LFE( mode ) && levels[5] != FSF_ONE)
+          return false;
+
+     return true;
+}
+
+/*
+ * Mask of the mixing buffer planes (indices of 'dest') written by the kernels for a source channel mode.
+ */
+static inline unsigned int
+mix_planes( FSChannelMode   mode,
+            __fsf         **dest )
+{
+     unsigned int planes = 0x03;
+
+     /* Center is written for all sources if there is a center plane, otherwise it's folded into left and right. */
+     if (dest[2])
+          planes |= 0x04;
+
+     if (FS_MODE_NUM_REARS( mode ))
+          planes |= 0x18;
+
+     if (FS_MODE_HAS_LFE( mode ) && dest[5])
+          planes |= 0x20;
+
+     return planes;
+}
+
+bool
+fs_buffer_unity_levels( CoreSoundBuffer *buffer,
+                        const __fsf      levels[6] )
+{
+     D_ASSERT( buffer != NULL );
+     D_ASSERT( levels != NULL );
+
+     return mix_unity_gain( buffer->mode, levels );
+}
+
 DirectResult
-fs_buffer_mixto( CoreSoundBuffer *buffer,
-                 __fsf           *dest,
-                 int              rate,
-                 FSChannelMode    mode,
-                 int              max_frames,
-                 int              pos,
-                 int              stop,
-                 __fsf            levels[6],
-                 int              pitch,
-                 int             *ret_pos,
-                 int             *ret_num,
-                 int             *ret_len )
+fs_buffer_mixto( CoreSoundBuffer   *buffer,
+                 __fsf             *mixing[6],
+                 int                rate,
+                 FSChannelMode      mode,
+                 int                max_frames,
+                 int                pos,
+                 int                stop,
+                 __fsf              levels[6],
+                 bool               unity,
+                 int                pitch,
+                 FSPlaybackQuality  quality,
+                 int               *ret_pos,
+                 int               *ret_num,
+                 int               *ret_len,
+                 unsigned int      *ret_planes )
 {
-     long long  inc;
-     long long  max;
-     int        num;
-     int        len;
-     bool       last = false;
+     long long     inc;
+     long long     max;
+     int           num;
+     int           len;
+     bool          last   = false;
+     unsigned int  planes = 0;
 
      D_ASSERT( buffer != NULL );
      D_ASSERT( buffer->data != NULL );
      D_ASSERT( pos >= 0 );
      D_ASSERT( pos < buffer->length );
      D_ASSERT( stop <= buffer->length );
-     D_ASSERT( dest != NULL );
+     D_ASSERT( mixing != NULL );
+     D_ASSERT( mixing[0] != NULL );
+     D_ASSERT( mixing[1] != NULL );
      D_ASSERT( max_frames >= 0 );
+     D_ASSERT( unity == mix_unity_gain( buffer->mode, levels ) );
+     D_ASSERT( quality >= FSPQ_NONE && quality <= FSPQ_SINC );
 
      D_DEBUG_AT( CoreSound_Buffer, "%s( %p, len %d, rate %d, mode %08x, max_frames %d, pos %d, stop %d )\n",
                  __FUNCTION__, buffer, buffer->length, rate, mode, max_frames, pos, stop );
@@ -389,11 +746,72 @@ fs_buffer_mixto( CoreSoundBuffer *buffer,
      /* Mix the data into the buffer. */
      if ((long) inc && (levels[0] || levels[1])) {
           SoundMXFunc func;
-          int         format_index  = FS_SAMPLEFORMAT_INDEX( buffer->format );
-          int         channel_index = FS_CHANNELS_FOR_MODE( buffer->mode ) - 1;
+          int         filter = (inc == FS_PITCH_ONE || inc == -FS_PITCH_ONE) ? MIX_FILTER_UNITY : quality;
+          int         before;
+          int         after;
+          long long   i      = 0;
+          u32         seam[(FS_SINC_TAPS + MIX_SEAM_FRAMES) * 6];
+
+          /* Single lookup of the kernel specialized for this call. */
+          func = MIX[fs_simd_level()]
+                    [filter]
+                    [FS_SAMPLEFORMAT_INDEX( buffer->format )]
+                    [mix_layout( buffer->mode )]
+                    [FS_MODE_HAS_CENTER( mode )]
+                    [unity]
+                    [pitch < 0];
+
+          before = mix_neighbours[filter].before;
+          after  = mix_neighbours[filter].after;
+
+          /*
+           * Split the mixing into runs which have all frames needed by the filter in one piece, so that the kernels
+           * do not need to wrap around. Runs at the seam of a looping buffer or the start and end of the data are mixed
+           * from a copy of the frames around the seam.
+           */
+          len = 0;
+
+          while (pitch < 0 ? i > max : i < max) {
+               long        frac = i & (FS_PITCH_ONE - 1);
+               long long   rest = max - (i - frac);
+               long long   run;
+               long        p    = ((i >> FS_PITCH_BITS) + pos) % buffer->length;
+               long        avail;
+               const void *data;
+               __fsf      *dest[6];
+               int         c;
+
+               if (p < 0)
+                    p += buffer->length;
+
+               if (p >= before && p + after < buffer->length) {
+                    data  = buffer->data;
+                    avail = buffer->length;
+               }
+               else {
+                    long first = (pitch < 0) ? p + after - (before + after + MIX_SEAM_FRAMES - 1) : p - before;
+
+                    mix_copy_seam( buffer, seam, first, before + after + MIX_SEAM_FRAMES );
+
+                    data  = seam;
+                    avail = before + after + MIX_SEAM_FRAMES;
+                    p    -= first;
+               }
 
-          func = (pitch < 0) ? MIX_RW[format_index][channel_index] : MIX_FW[format_index][channel_index];
-          len  = func( buffer, dest, mode, pos, inc, max, levels, last );
+               if (pitch < 0)
+                    run = MAX( rest, ((long long)(before - p) << FS_PITCH_BITS) - 1 );
+               else
+                    run = MIN( rest, (long long)(avail - after - p) << FS_PITCH_BITS );
+
+               for (c = 0; c < 6; c++)
+                    dest[c] = mixing[c] ? mixing[c] + len : NULL;
+
+               num  = func( data, dest, p, frac, inc, run, levels, last && run == rest );
+               len += num;
+               i   += (long long) num * inc;
+          }
+
+          planes = mix_planes( buffer->mode, mixing );
      }
      else {
           /* Produce silence. */
@@ -418,6 +836,10 @@ fs_buffer_mixto( CoreSoundBuffer *buffer,
      if (ret_len)
           *ret_len = len;
 
+     /* Return mixing buffer planes written. */
+     if (ret_planes)
+          *ret_planes = planes;
+
      D_DEBUG_AT( CoreSound_Buffer, "  -> new pos %d, mixed %d (%d/%d)\n", pos, ABS( num ), len, max_frames );
 
      return last ? DR_BUFFEREMPTY : DR_OK;
@@ -21,6 +21,7 @@
 
 #include <core/coretypes_sound.h>
 #include <core/fs_types.h>
+#include <fusion/call.h>
 #include <fusion/object.h>
 
 /**********************************************************************************************************************/
@@ -53,6 +54,7 @@ DirectResult      fs_buffer_create     ( CoreSound          *core,
                                          FSChannelMode       mode,
                                          FSSampleFormat      format,
                                          int                 rate,
+                                         bool                mirror,
                                          CoreSoundBuffer   **ret_buffer );
 
 DirectResult      fs_buffer_lock        ( CoreSoundBuffer   *buffer,
@@ -61,23 +63,86 @@ DirectResult      fs_buffer_lock        ( CoreSoundBuffer   *buffer,
                                          void              **ret_data,
                                          int                *ret_bytes );
 
+/*
+ * Copies frames written past the end of a mirrored buffer to its beginning, so that a region locked across the end
+ * is stored in place.
+ */
+DirectResult      fs_buffer_wrap        ( CoreSoundBuffer   *buffer,
+                                          int                length );
+
 DirectResult      fs_buffer_unlock      ( CoreSoundBuffer   *buffer );
 
 int               fs_buffer_bytes       ( CoreSoundBuffer   *buffer );
 
 FSChannelMode     fs_buffer_mode        ( CoreSoundBuffer   *buffer );
 
+int               fs_buffer_length      ( CoreSoundBuffer   *buffer );
+
+/*
+ * Use the buffer as the ring buffer of a stream, with the frames between the read and the write index being played.
+ */
+void              fs_buffer_ring_enable ( CoreSoundBuffer   *buffer );
+
+/*
+ * Returns the number of frames written and read in total, or false if the buffer is not used as a ring buffer.
+ */
+bool              fs_buffer_ring_get    ( CoreSoundBuffer   *buffer,
+                                          unsigned int      *ret_written,
+                                          unsigned int      *ret_read );
+
+/*
+ * Publishes the number of frames written in total, after the data has been written.
+ */
+void              fs_buffer_ring_write  ( CoreSoundBuffer   *buffer,
+                                          unsigned int       written );
+
+/*
+ * Publishes the number of frames read in total, after the data has been mixed.
+ */
+void              fs_buffer_ring_read   ( CoreSoundBuffer   *buffer,
+                                          unsigned int       read );
+
+/*
+ * Lets the sound thread request frames from the writer of a ring buffer through a call, with the number of frames
+ * requested as the call argument.
+ */
+DirectResult      fs_buffer_ring_pull_init  ( CoreSoundBuffer   *buffer,
+                                              const FusionWorld *world,
+                                              FusionCallHandler  handler,
+                                              void              *ctx );
+
+void              fs_buffer_ring_pull_deinit( CoreSoundBuffer   *buffer );
+
+/*
+ * Requests the frames missing for mixing 'max_frames' at 'rate' and 'pitch' from the writer, if frames are pulled.
+ * The call is synchronous, the writer may return fewer frames, which are mixed as an underrun.
+ */
+DirectResult      fs_buffer_ring_pull       ( CoreSoundBuffer   *buffer,
+                                              int                rate,
+                                              int                max_frames,
+                                              int                pitch );
+
+/*
+ * Check whether all levels used by the channel mode of the buffer are at unity, which selects the kernels that do not
+ * apply levels in fs_buffer_mixto().
+ */
+bool              fs_buffer_unity_levels( CoreSoundBuffer   *buffer,
+                                          const __fsf        levels[6] );
+
 DirectResult      fs_buffer_mixto       ( CoreSoundBuffer   *buffer,
-                                          __fsf             *dest,
+                                          __fsf             *mixing[6],
                                           int                rate,
                                           FSChannelMode      mode,
                                           int                max_frames,
                                           int                pos,
                                           int                stop,
                                           __fsf              levels[6],
+                                          bool               unity,
                                           int                pitch,
+                                          FSPlaybackQuality  quality,
                                           int               *ret_pos,
                                           int               *ret_num,
-                                          int               *ret_written );
+                                          int               *ret_written,
+                                          unsigned int      *ret_planes );
 
 #endif
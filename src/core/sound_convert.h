@@ -0,0 +1,134 @@
+/*
+   This file is part of DirectFB.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+/*
+ * Output conversion kernels.
+ *
+ * Convert 'num' samples, already in the device channel layout, to the device sample format, clipping each sample.
+ * Formats with a saturating pack (SIMD_U8, SIMD_S16) use it for all complete vectors, the remaining samples and the
+ * other formats use branch-free loops the compiler vectorizes for the target.
+ */
+
+#define GEN_CONVERT_NAME( format, simd ) convert_to_##format##_##simd
+#define SIMD_CONVERT_NAME( format, simd ) GEN_CONVERT_NAME( format, simd )
+#define CONVERT_NAME( format ) SIMD_CONVERT_NAME( format, SIMD_NAME )
+
+#ifndef SIMD_NAME
+#warning SIMD_NAME is not defined!
+#endif
+
+#ifndef SIMD_ATTR
+#warning SIMD_ATTR is not defined!
+#endif
+
+static SIMD_ATTR void
+CONVERT_NAME(u8) ( const __fsf *src,
+                   u8          *dst,
+                   int          num )
+{
+     int i = 0;
+
+#ifdef SIMD_U8
+     for (; i <= num - SIMD_U8_LANES; i += SIMD_U8_LANES)
+          SIMD_U8( src + i, dst + i );
+#endif
+
+     for (; i < num; i++) {
+          __fsf s = fsf_clip( src[i] );
+
+          dst[i] = fsf_to_u8( s );
+     }
+}
+
+static SIMD_ATTR void
+CONVERT_NAME(s16) ( const __fsf *src,
+                    u8          *dst,
+                    int          num )
+{
+     int  i = 0;
+     u16 *d = (u16*) dst;
+
+#ifdef SIMD_S16
+     for (; i <= num - SIMD_S16_LANES; i += SIMD_S16_LANES)
+          SIMD_S16( src + i, dst + i * 2 );
+#endif
+
+     for (; i < num; i++) {
+          __fsf s = fsf_clip( src[i] );
+
+          d[i] = (int) fsf_to_s16( s );
+     }
+}
+
+static SIMD_ATTR void
+CONVERT_NAME(s24) ( const __fsf *src,
+                    u8          *dst,
+                    int          num )
+{
+     int i;
+
+     for (i = 0; i < num; i++) {
+          __fsf s = fsf_clip( src[i] );
+          int   d = fsf_to_s24( s );
+
+#ifdef WORDS_BIGENDIAN
+          dst[0] = d >> 16;
+          dst[1] = d >>  8;
+          dst[2] = d;
+#else
+          dst[0] = d;
+          dst[1] = d >>  8;
+          dst[2] = d >> 16;
+#endif
+          dst += 3;
+     }
+}
+
+static SIMD_ATTR void
+CONVERT_NAME(s32) ( const __fsf *src,
+                    u8          *dst,
+                    int          num )
+{
+     int  i;
+     u32 *d = (u32*) dst;
+
+     for (i = 0; i < num; i++) {
+          __fsf s = fsf_clip( src[i] );
+
+          d[i] = (int) fsf_to_s32( s );
+     }
+}
+
+static SIMD_ATTR void
+CONVERT_NAME(f32) ( const __fsf *src,
+                    u8          *dst,
+                    int          num )
+{
+     int    i;
+     float *d = (float*) dst;
+
+     for (i = 0; i < num; i++) {
+          __fsf s = fsf_clip( src[i] );
+
+          d[i] = fsf_to_float( s );
+     }
+}
+
+#undef CONVERT_NAME
+#undef SIMD_CONVERT_NAME
+#undef GEN_CONVERT_NAME
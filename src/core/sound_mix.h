@@ -16,8 +16,19 @@
    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
 */
 
-#define GEN_FUNC_NAME( format, mode, dir ) mix_from_##format##_##mode##_##dir
-#define FUNC_NAME( format, mode, dir ) GEN_FUNC_NAME( format, mode, dir )
+/*
+ * Mixing kernels for one source format (FORMAT, TYPE and FSF_FROM_SRC, with FSF_VEC_FROM_SRC if the samples can be
+ * converted with vector operations).
+ *
+ * Kernels are specialized for each source channel mode (sound_mix_layout.h), for a mixing buffer with or without a
+ * center channel, for unity or arbitrary levels, for each direction and for each interpolation quality, so that the
+ * sample loops contain no decisions. Kernels mix runs that do not cross the end of the source data, including the
+ * neighbours read by the filter, with 'pos' being the frame and 'i' the fraction of the start position, into the
+ * planes of the mixing buffer given in 'dest'. Layouts are given as FS_CHANNELMODE() for use in preprocessor
+ * conditions. Kernels are named
+ *
+ *   mix_from_<format>_<layout>_<lr|lcr>_<gain|nogain>_<fw|rw>_<filter>
+ */
 
 #ifndef FORMAT
 #warning FORMAT is not defined!
@@ -31,859 +42,155 @@
 #warning FSF_FROM_SRC() is not defined!
 #endif
 
-#define FSF_INTERP( a, b, w )    \
-__extension__( {                 \
-     register __fsf _a = (a);    \
-     register __fsf _b = (b);    \
-     _a + fsf_mul( _b - _a, w ); \
-} )
-
-static int
-FUNC_NAME(FORMAT,mono,fw) ( CoreSoundBuffer *buffer,
-                            __fsf           *dest,
-                            FSChannelMode    mode,
-                            long             pos,
-                            long             inc,
-                            long             max,
-                            __fsf            levels[6],
-                            bool             last )
-
-{
-     long   i     = 0;
-     TYPE  *src   = buffer->data;
-     __fsf *dst   = dest;
-     __fsf  left  = levels[0];
-     __fsf  right = levels[1];
-
-#if FS_LINEAR_FILTER
-     if (inc < FS_PITCH_ONE) {
-          /* upsample */
-          if (last)
-               max -= FS_PITCH_ONE;
-
-          for (; i < max; i += inc) {
-               long  p = (i >> FS_PITCH_BITS) + pos;
-               __fsf s, sl, sr;
-
-               if (p >= buffer->length)
-                    p %= buffer->length;
-
-               s = FSF_FROM_SRC( src, p );
-
-               if (i & (FS_PITCH_ONE - 1)) {
-                    __fsf w;
-                    long  q = p + 1;
-
-                    if (q == buffer->length)
-                         q = 0;
-
-                    w = fsf_from_int_scaled( i & (FS_PITCH_ONE - 1), FS_PITCH_BITS );
-
-                    s = FSF_INTERP( s, FSF_FROM_SRC( src, q ), w );
-               }
-
-               sl = (left  == FSF_ONE) ? s : fsf_mul( s, left );
-               sr = (right == FSF_ONE) ? s : fsf_mul( s, right );
-
-               dst[0] += sl;
-               dst[1] += sr;
-               if (FS_MODE_HAS_CENTER( mode ))
-                    dst[2] += fsf_shr( sl + sr, 1 );
-
-               dst += FS_MAX_CHANNELS;
-          }
-
-          if (last)
-               max += FS_PITCH_ONE;
-     }
-#endif /* FS_LINEAR_FILTER */
-
-     for (; i < max; i += inc) {
-          long  p = (i >> FS_PITCH_BITS) + pos;
-          __fsf s, sl, sr;
-
-          if (p >= buffer->length)
-               p %= buffer->length;
-
-          s = FSF_FROM_SRC( src, p );
-
-          sl = (left  == FSF_ONE) ? s : fsf_mul( s, left );
-          sr = (right == FSF_ONE) ? s : fsf_mul( s, right );
-
-          dst[0] += sl;
-          dst[1] += sr;
-          if (FS_MODE_HAS_CENTER( mode ))
-               dst[2] += fsf_shr( sl + sr, 1 );
-
-          dst += FS_MAX_CHANNELS;
-     }
-
-     return (dst - dest) / FS_MAX_CHANNELS;
-}
-
-static int
-FUNC_NAME(FORMAT,mono,rw) ( CoreSoundBuffer *buffer,
-                            __fsf           *dest,
-                            FSChannelMode    mode,
-                            long             pos,
-                            long             inc,
-                            long             max,
-                            __fsf            levels[6],
-                            bool             last )
-
-{
-     long   i     = 0;
-     TYPE  *src   = buffer->data;
-     __fsf *dst   = dest;
-     __fsf  left  = levels[0];
-     __fsf  right = levels[1];
-
-#if FS_LINEAR_FILTER
-     if (-inc < FS_PITCH_ONE) {
-          /* upsample */
-          if (last)
-               max += FS_PITCH_ONE;
-
-          for (; i > max; i += inc) {
-               long  p = (i >> FS_PITCH_BITS) + pos;
-               __fsf s, sl, sr;
-
-               if (p <= -buffer->length)
-                    p %= buffer->length;
-               if (p < 0)
-                    p += buffer->length;
-
-               s = FSF_FROM_SRC( src, p );
-
-               if (-i & (FS_PITCH_ONE - 1)) {
-                    __fsf w;
-                    long  q = p - 1;
-
-                    if (q == -1)
-                         q += buffer->length;
-
-                    w = fsf_from_int_scaled( -i & (FS_PITCH_ONE - 1), FS_PITCH_BITS );
-
-                    s = FSF_INTERP( s, FSF_FROM_SRC( src, q ), w );
-               }
-
-               sl = (left  == FSF_ONE) ? s : fsf_mul( s, left );
-               sr = (right == FSF_ONE) ? s : fsf_mul( s, right );
-
-               dst[0] += sl;
-               dst[1] += sr;
-               if (FS_MODE_HAS_CENTER( mode ))
-                    dst[2] += fsf_shr( sl + sr, 1 );
-
-               dst += FS_MAX_CHANNELS;
-          }
-
-          if (last)
-               max -= FS_PITCH_ONE;
-     }
-#endif /* FS_LINEAR_FILTER */
-
-     for (; i > max; i += inc) {
-          long  p = (i >> FS_PITCH_BITS) + pos;
-          __fsf s, sl, sr;
-
-          if (p <= -buffer->length)
-               p %= buffer->length;
-          if (p < 0)
-               p += buffer->length;
-
-          s = FSF_FROM_SRC( src, p );
-
-          sl = (left  == FSF_ONE) ? s : fsf_mul( s, left );
-          sr = (right == FSF_ONE) ? s : fsf_mul( s, right );
-
-          dst[0] += sl;
-          dst[1] += sr;
-          if (FS_MODE_HAS_CENTER( mode ))
-               dst[2] += fsf_shr( sl + sr, 1 );
-
-          dst += FS_MAX_CHANNELS;
-     }
-
-     return (dst - dest) / FS_MAX_CHANNELS;
-}
-
-static int
-FUNC_NAME(FORMAT,stereo,fw) ( CoreSoundBuffer *buffer,
-                              __fsf           *dest,
-                              FSChannelMode    mode,
-                              long             pos,
-                              long             inc,
-                              long             max,
-                              __fsf            levels[6],
-                              bool             last )
-{
-     long   i     = 0;
-     TYPE  *src   = buffer->data;
-     __fsf *dst   = dest;
-     __fsf  left  = levels[0];
-     __fsf  right = levels[1];
-
-#if FS_LINEAR_FILTER
-     if (inc < FS_PITCH_ONE) {
-          /* upsample */
-          if (last)
-               max -= FS_PITCH_ONE;
+#define GEN_MIX_NAME( format, layout, output, gain, dir, filter ) \
+     mix_from_##format##_##layout##_##output##_##gain##_##dir##_##filter
+#define LAYOUT_MIX_NAME( format, layout, output, gain, dir, filter ) \
+     GEN_MIX_NAME( format, layout, output, gain, dir, filter )
+#define MIX_NAME( dir, filter ) LAYOUT_MIX_NAME( FORMAT, LAYOUT, OUTPUT, GAIN, dir, filter )
 
-          for (; i < max; i += inc) {
-               long  p = (i >> FS_PITCH_BITS) + pos;
-               __fsf sl, sr;
+#define GEN_SIMD_FILTER( filter, simd ) filter##_##simd
+#define SIMD_FILTER( filter, simd ) GEN_SIMD_FILTER( filter, simd )
 
-               if (p >= buffer->length)
-                    p %= buffer->length;
+/* Sample with level applied. */
+#define MIX_LEVEL( s, level ) (GAIN_UNITY ? (s) : fsf_mul( s, level ))
 
-               if (i & (FS_PITCH_ONE - 1)) {
-                    __fsf w;
-                    long  q = p + 1;
-
-                    if (q == buffer->length)
-                         q = 0;
-
-                    p <<= 1;
-                    q <<= 1;
-
-                    w  = fsf_from_int_scaled( i & (FS_PITCH_ONE - 1), FS_PITCH_BITS );
-
-                    sl = FSF_INTERP( FSF_FROM_SRC( src, p ),     FSF_FROM_SRC( src, q ),     w );
-                    sr = FSF_INTERP( FSF_FROM_SRC( src, p + 1 ), FSF_FROM_SRC( src, q + 1 ), w );
-
-                    if (left != FSF_ONE)
-                         sl = fsf_mul( sl, left );
-                    if (right != FSF_ONE)
-                         sr = fsf_mul( sr, right );
-               }
-               else {
-                    p <<= 1;
-
-                    sl = (left  == FSF_ONE) ? FSF_FROM_SRC( src, p )     : fsf_mul( FSF_FROM_SRC( src, p ),     left );
-                    sr = (right == FSF_ONE) ? FSF_FROM_SRC( src, p + 1 ) : fsf_mul( FSF_FROM_SRC( src, p + 1 ), right );
-               }
-
-               dst[0] += sl;
-               dst[1] += sr;
-               if (FS_MODE_HAS_CENTER( mode ))
-                    dst[2] += fsf_shr( sl + sr, 1 );
-
-               dst += FS_MAX_CHANNELS;
-          }
-
-          if (last)
-               max += FS_PITCH_ONE;
-     }
-#endif /* FS_LINEAR_FILTER */
-
-     for (; i < max; i += inc) {
-          long  p = (i >> FS_PITCH_BITS) + pos;
-          __fsf sl, sr;
-
-          if (p >= buffer->length)
-               p %= buffer->length;
-
-          p <<= 1;
-
-          sl = (left  == FSF_ONE) ? FSF_FROM_SRC( src, p )     : fsf_mul( FSF_FROM_SRC( src, p ),     left );
-          sr = (right == FSF_ONE) ? FSF_FROM_SRC( src, p + 1 ) : fsf_mul( FSF_FROM_SRC( src, p + 1 ), right );
-
-          dst[0] += sl;
-          dst[1] += sr;
-          if (FS_MODE_HAS_CENTER( mode ))
-               dst[2] += fsf_shr( sl + sr, 1 );
-
-          dst += FS_MAX_CHANNELS;
-     }
-
-     return (dst - dest) / FS_MAX_CHANNELS;
-}
-
-static int
-FUNC_NAME(FORMAT,stereo,rw) ( CoreSoundBuffer *buffer,
-                              __fsf           *dest,
-                              FSChannelMode    mode,
-                              long             pos,
-                              long             inc,
-                              long             max,
-                              __fsf            levels[6],
-                              bool             last )
-{
-     long   i     = 0;
-     TYPE  *src   = buffer->data;
-     __fsf *dst   = dest;
-     __fsf  left  = levels[0];
-     __fsf  right = levels[1];
-
-#if FS_LINEAR_FILTER
-     if (-inc < FS_PITCH_ONE) {
-          /* upsample */
-          if (last)
-               max += FS_PITCH_ONE;
-
-          for (; i > max; i += inc) {
-               long  p = (i >> FS_PITCH_BITS) + pos;
-               __fsf sl, sr;
-
-               if (p <= -buffer->length)
-                    p %= buffer->length;
-               if (p < 0)
-                    p += buffer->length;
-
-               if (-i & (FS_PITCH_ONE - 1)) {
-                    __fsf w;
-                    long  q = p - 1;
-
-                    if (q == -1)
-                         q += buffer->length;
-
-                    p <<= 1;
-                    q <<= 1;
-
-                    w  = fsf_from_int_scaled( -i & (FS_PITCH_ONE - 1), FS_PITCH_BITS );
-
-                    sl = FSF_INTERP( FSF_FROM_SRC( src, p ),     FSF_FROM_SRC( src, q ),     w );
-                    sr = FSF_INTERP( FSF_FROM_SRC( src, p + 1 ), FSF_FROM_SRC( src, q + 1 ), w );
-
-                    if (left != FSF_ONE)
-                         sl = fsf_mul( sl, left );
-                    if (right != FSF_ONE)
-                         sr = fsf_mul( sr, right );
-               }
-               else {
-                    p <<= 1;
-
-                    sl = (left  == FSF_ONE) ? FSF_FROM_SRC( src, p )     : fsf_mul( FSF_FROM_SRC( src, p ),     left );
-                    sr = (right == FSF_ONE) ? FSF_FROM_SRC( src, p + 1 ) : fsf_mul( FSF_FROM_SRC( src, p + 1 ), right );
-               }
-
-               dst[0] += sl;
-               dst[1] += sr;
-               if (FS_MODE_HAS_CENTER( mode ))
-                    dst[2] += fsf_shr( sl + sr, 1 );
-
-               dst += FS_MAX_CHANNELS;
-          }
-
-          if (last)
-               max -= FS_PITCH_ONE;
-     }
-#endif /* FS_LINEAR_FILTER */
-
-     for (; i > max; i += inc) {
-          long  p = (i >> FS_PITCH_BITS) + pos;
-          __fsf sl, sr;
-
-          if (p <= -buffer->length)
-               p %= buffer->length;
-          if (p < 0)
-               p += buffer->length;
-
-          p <<= 1;
-
-          sl = (left  == FSF_ONE) ? FSF_FROM_SRC( src, p )     : fsf_mul( FSF_FROM_SRC( src, p ),     left );
-          sr = (right == FSF_ONE) ? FSF_FROM_SRC( src, p + 1 ) : fsf_mul( FSF_FROM_SRC( src, p + 1 ), right );
-
-          dst[0] += sl;
-          dst[1] += sr;
-          if (FS_MODE_HAS_CENTER( mode ))
-               dst[2] += fsf_shr( sl + sr, 1 );
-
-          dst += FS_MAX_CHANNELS;
-     }
+/*
+ * Index of the first rear and of the subwoofer channel within a source frame. FSCM_STEREO31 is encoded with three
+ * channels, which leaves no room for its subwoofer.
+ */
+#define MIX_REAR (FS_MODE_HAS_CENTER( LAYOUT_MODE ) ? 3 : 2)
+#define MIX_LFE  (MIX_REAR + FS_MODE_NUM_REARS( LAYOUT_MODE ))
 
-     return (dst - dest) / FS_MAX_CHANNELS;
-}
+/*
+ * Add the values of one source frame to frame 'n' of the mixing buffer planes. All conditions except the presence of
+ * a subwoofer plane are constant for a kernel. Without a center plane (OUTPUT_CENTER), the center channel of the
+ * source is folded into the front planes, rears may have been mapped to the front planes by the caller.
+ */
+#define MIX_FRAME( dst, n, values )                                                    \
+     do {                                                                              \
+          if (!FS_MODE_HAS_CENTER( LAYOUT_MODE )) {                                    \
+               __fsf _sl = MIX_LEVEL( (values)[0],                   levels[0] );      \
+               __fsf _sr = MIX_LEVEL( (values)[LAYOUT_CHANNELS > 1], levels[1] );      \
+                                                                                       \
+               (dst)[0][n] += _sl;                                                     \
+               (dst)[1][n] += _sr;                                                     \
+               if (OUTPUT_CENTER)                                                      \
+                    (dst)[2][n] += fsf_shr( _sl + _sr, 1 );                            \
+          }                                                                            \
+          else {                                                                       \
+               __fsf _sc = MIX_LEVEL( (values)[1], levels[2] );                        \
+                                                                                       \
+               (dst)[0][n] += MIX_LEVEL( (values)[0], levels[0] );                     \
+               (dst)[1][n] += MIX_LEVEL( (values)[2], levels[1] );                     \
+               if (OUTPUT_CENTER)                                                      \
+                    (dst)[2][n] += _sc;                                                \
+               else {                                                                  \
+                    (dst)[0][n] += _sc;                                                \
+                    (dst)[1][n] += _sc;                                                \
+               }                                                                       \
+          }                                                                            \
+                                                                                       \
+          if (FS_MODE_NUM_REARS( LAYOUT_MODE ) == 1) {                                 \
+               (dst)[3][n] += MIX_LEVEL( (values)[MIX_REAR], levels[3] );              \
+               (dst)[4][n] += MIX_LEVEL( (values)[MIX_REAR], levels[4] );              \
+          }                                                                            \
+          else if (FS_MODE_NUM_REARS( LAYOUT_MODE ) == 2) {                            \
+               (dst)[3][n] += MIX_LEVEL( (values)[MIX_REAR],     levels[3] );          \
+               (dst)[4][n] += MIX_LEVEL( (values)[MIX_REAR + 1], levels[4] );          \
+          }                                                                            \
+                                                                                       \
+          if (FS_MODE_HAS_LFE( LAYOUT_MODE ) && MIX_LFE < LAYOUT_CHANNELS && (dst)[5]) \
+               (dst)[5][n] += MIX_LEVEL( (values)[MIX_LFE], levels[5] );               \
+     } while (0)
+
+#define LAYOUT      mono
+#define LAYOUT_MODE FS_CHANNELMODE( 1, 0, 0, 0 ) /* FSCM_MONO */
+#include "sound_mix_layout.h"
+#undef  LAYOUT_MODE
+#undef  LAYOUT
+
+#define LAYOUT      stereo
+#define LAYOUT_MODE FS_CHANNELMODE( 2, 0, 0, 0 ) /* FSCM_STEREO */
+#include "sound_mix_layout.h"
+#undef  LAYOUT_MODE
+#undef  LAYOUT
 
 #if FS_MAX_CHANNELS > 2
-static int
-FUNC_NAME(FORMAT,multi,fw) ( CoreSoundBuffer *buffer,
-                             __fsf           *dest,
-                             FSChannelMode    mode,
-                             long             pos,
-                             long             inc,
-                             long             max,
-                             __fsf            levels[6],
-                             bool             last )
-{
-     long   i        = 0;
-     TYPE  *src      = buffer->data;
-     __fsf *dst      = dest;
-     int    channels = FS_CHANNELS_FOR_MODE( buffer->mode );
-
-#if FS_LINEAR_FILTER
-     if (inc < FS_PITCH_ONE) {
-          /* upsample */
-          if (last)
-               max -= FS_PITCH_ONE;
-
-          for (; i < max; i += inc) {
-               long p = (i >> FS_PITCH_BITS) + pos;
-
-               if (p >= buffer->length)
-                    p %= buffer->length;
-
-               if (i & (FS_PITCH_ONE - 1)) {
-                    __fsf w, s;
-                    long  q = p + 1;
-
-                    if (q == buffer->length)
-                         q = 0;
-
-                    p *= channels;
-                    q *= channels;
-
-                    w = fsf_from_int_scaled( i & (FS_PITCH_ONE - 1), FS_PITCH_BITS );
-
-                    if (!FS_MODE_HAS_CENTER( buffer->mode )) {
-                         __fsf sl, sr;
-
-                         /* front left */
-                         sl = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[0] != FSF_ONE)
-                              sl = fsf_mul( sl, levels[0] );
-                         p++; q++;
-
-                         /* front right */
-                         sr = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[1] != FSF_ONE)
-                              sr = fsf_mul( sr, levels[1] );
-                         p++; q++;
-
-                         dst[0] += sl;
-                         dst[1] += sr;
-                         if (FS_MODE_HAS_CENTER( mode ))
-                              dst[2] += fsf_shr( sl + sr, 1 );
-                    }
-                    else {
-                         /* front left */
-                         s = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[0] != FSF_ONE)
-                              s = fsf_mul( s, levels[0] );
-                         dst[0] += s;
-                         p++; q++;
-
-                         /* front center */
-                         s = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[2] != FSF_ONE)
-                              s = fsf_mul( s, levels[2] );
-                         dst[2] += s;
-                         p++; q++;
-
-                         /* front right */
-                         s = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[1] != FSF_ONE)
-                              s = fsf_mul( s, levels[1] );
-                         dst[1] += s;
-                         p++; q++;
-                    }
-
-                    if (FS_MODE_NUM_REARS( buffer->mode ) == 1) {
-                         /* rear */
-                         s = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         p++; q++;
-
-                         dst[3] += (levels[3] == FSF_ONE) ? s : fsf_mul( s, levels[3] );
-                         dst[4] += (levels[4] == FSF_ONE) ? s : fsf_mul( s, levels[4] );
-                    }
-                    else if (FS_MODE_NUM_REARS( buffer->mode ) == 2) {
-                         /* rear left */
-                         s = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[3] != FSF_ONE)
-                              s = fsf_mul( s, levels[3] );
-                         dst[3] += s;
-                         p++; q++;
-
-                         /* rear right */
-                         s = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[4] != FSF_ONE)
-                              s = fsf_mul( s, levels[4] );
-                         dst[4] += s;
-                         p++; q++;
-                    }
-
-                    if (FS_MODE_HAS_LFE( buffer->mode )) {
-                         /* subwoofer */
-                         s = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[5] != FSF_ONE)
-                              s = fsf_mul( s, levels[5] );
-                         dst[5] += s;
-                    }
-               }
-               else {
-                    p *= channels;
-
-                    if (!FS_MODE_HAS_CENTER( buffer->mode )) {
-                         __fsf sl, sr;
-
-                         sl = (levels[0] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                         levels[0] );
-                         p++;
-
-                         sr = (levels[1] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                         levels[1] );
-                         p++;
-
-                         dst[0] += sl;
-                         dst[1] += sr;
-                         if (FS_MODE_HAS_CENTER( mode ))
-                              dst[2] += fsf_shr( sl + sr, 1 );
-
-                    }
-                    else {
-                         dst[0] += (levels[0] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                              levels[0] );
-                         p++;
-
-                         dst[2] += (levels[2] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                              levels[2] );
-                         p++;
-
-                         dst[1] += (levels[1] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                              levels[1] );
-                         p++;
-                    }
-
-                    if (FS_MODE_NUM_REARS( buffer->mode ) == 1) {
-                         __fsf s;
-
-                         s = FSF_FROM_SRC( src, p );
-                         p++;
-
-                         dst[3] += (levels[3] == FSF_ONE) ? s : fsf_mul( s, levels[3] );
-                         dst[4] += (levels[4] == FSF_ONE) ? s : fsf_mul( s, levels[4] );
-                    }
-                    else if (FS_MODE_NUM_REARS( buffer->mode ) == 2) {
-                         dst[3] += (levels[3] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                              levels[3] );
-                         p++;
-
-                         dst[4] += (levels[4] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                              levels[4] );
-                         p++;
-                    }
-
-                    if (FS_MODE_HAS_LFE( buffer->mode )) {
-                         dst[5] += (levels[5] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                              levels[5] );
-                    }
-               }
-
-               dst += FS_MAX_CHANNELS;
-          }
-
-          if (last)
-               max += FS_PITCH_ONE;
-     }
-#endif /* FS_LINEAR_FILTER */
-
-     for (; i < max; i += inc) {
-          long p = (i >> FS_PITCH_BITS) + pos;
-
-          if (p >= buffer->length)
-               p %= buffer->length;
-
-          p *= channels;
-
-          if (!FS_MODE_HAS_CENTER( buffer->mode )) {
-               __fsf sl, sr;
-
-               sl = (levels[0] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[0] );
-               p++;
-
-               sr = (levels[1] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[1] );
-               p++;
-
-               dst[0] += sl;
-               dst[1] += sr;
-               if (FS_MODE_HAS_CENTER( mode ))
-                    dst[2] += fsf_shr( sl + sr, 1 );
-          }
-          else {
-               dst[0] += (levels[0] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[0] );
-               p++;
-
-               dst[2] += (levels[2] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[2] );
-               p++;
-
-               dst[1] += (levels[1] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[1] );
-               p++;
-          }
-
-          if (FS_MODE_NUM_REARS( buffer->mode ) == 1) {
-               __fsf s;
-
-               s = FSF_FROM_SRC( src, p );
-               p++;
-
-               dst[3] += (levels[3] == FSF_ONE) ? s : fsf_mul( s, levels[3] );
-               dst[4] += (levels[4] == FSF_ONE) ? s : fsf_mul( s, levels[4] );
-          }
-          else if (FS_MODE_NUM_REARS( buffer->mode ) == 2) {
-               dst[3] += (levels[3] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[3] );
-               p++;
-
-               dst[4] += (levels[4] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[4] );
-               p++;
-          }
-
-          if (FS_MODE_HAS_LFE( buffer->mode )) {
-               dst[5] += (levels[5] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[5] );
-          }
-
-          dst += FS_MAX_CHANNELS;
-     }
-
-     return (dst - dest) / FS_MAX_CHANNELS;
-}
-
-static int
-FUNC_NAME(FORMAT,multi,rw) ( CoreSoundBuffer *buffer,
-                             __fsf           *dest,
-                             FSChannelMode    mode,
-                             long             pos,
-                             long             inc,
-                             long             max,
-                             __fsf            levels[6],
-                             bool             last )
-{
-     long   i        = 0;
-     TYPE  *src      = buffer->data;
-     __fsf *dst      = dest;
-     int    channels = FS_CHANNELS_FOR_MODE( buffer->mode );
-
-#if FS_LINEAR_FILTER
-     if (-inc < FS_PITCH_ONE) {
-          /* upsample */
-          if (last)
-               max -= FS_PITCH_ONE;
-
-          for (; i > max; i += inc) {
-               long p = (i >> FS_PITCH_BITS) + pos;
-
-               if (p <= -buffer->length)
-                    p %= buffer->length;
-               if (p < 0)
-                    p += buffer->length;
-
-               if (i & (FS_PITCH_ONE-1)) {
-                    __fsf w, s;
-                    long  q = p - 1;
-
-                    if (q == -1)
-                         q += buffer->length;
-
-                    p *= channels;
-                    q *= channels;
-
-                    w = fsf_from_int_scaled( -i & (FS_PITCH_ONE - 1), FS_PITCH_BITS );
-
-                    if (!FS_MODE_HAS_CENTER( buffer->mode )) {
-                         __fsf sl, sr;
-
-                         /* front left */
-                         sl = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[0] != FSF_ONE)
-                              sl = fsf_mul( sl, levels[0] );
-                         p++; q++;
-
-                         /* front right */
-                         sr = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[1] != FSF_ONE)
-                              sr = fsf_mul( sr, levels[1] );
-                         p++; q++;
-
-                         dst[0] += sl;
-                         dst[1] += sr;
-                         if (FS_MODE_HAS_CENTER( mode ))
-                              dst[2] += fsf_shr( sl + sr, 1 );
-                    }
-                    else {
-                         /* front left */
-                         s = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[0] != FSF_ONE)
-                              s = fsf_mul( s, levels[0] );
-                         dst[0] += s;
-                         p++; q++;
-
-                         /* front center */
-                         s = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[2] != FSF_ONE)
-                              s = fsf_mul( s, levels[2] );
-                         dst[2] += s;
-                         p++; q++;
-
-                         /* front right */
-                         s = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[1] != FSF_ONE)
-                              s = fsf_mul( s, levels[1] );
-                         dst[1] += s;
-                         p++; q++;
-                    }
-
-                    if (FS_MODE_NUM_REARS( buffer->mode ) == 1) {
-                         /* rear */
-                         s = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         p++; q++;
-
-                         dst[3] += (levels[3] == FSF_ONE) ? s : fsf_mul( s, levels[3] );
-                         dst[4] += (levels[4] == FSF_ONE) ? s : fsf_mul( s, levels[4] );
-                    }
-                    else if (FS_MODE_NUM_REARS( buffer->mode ) == 2) {
-                         /* rear left */
-                         s = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[3] != FSF_ONE)
-                              s = fsf_mul( s, levels[3] );
-                         dst[3] += s;
-                         p++; q++;
-
-                         /* rear right */
-                         s = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[4] != FSF_ONE)
-                              s = fsf_mul( s, levels[4] );
-                         dst[4] += s;
-                         p++; q++;
-                    }
-
-                    if (FS_MODE_HAS_LFE( buffer->mode )) {
-                         /* subwoofer */
-                         s = FSF_INTERP( FSF_FROM_SRC( src, p ), FSF_FROM_SRC( src, q ), w );
-                         if (levels[5] != FSF_ONE)
-                              s = fsf_mul( s, levels[5] );
-                         dst[5] += s;
-                    }
-               }
-               else {
-                    p *= channels;
-
-                    if (!FS_MODE_HAS_CENTER( buffer->mode )) {
-                         __fsf sl, sr;
-
-                         sl = (levels[0] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                         levels[0] );
-                         p++;
-
-                         sr = (levels[1] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                         levels[1] );
-                         p++;
-
-                         dst[0] += sl;
-                         dst[1] += sr;
-                         if (FS_MODE_HAS_CENTER( mode ))
-                              dst[2] += fsf_shr( sl + sr, 1 );
-                    }
-                    else {
-                         dst[0] += (levels[0] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                              levels[0] );
-                         p++;
-
-                         dst[2] += (levels[2] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                              levels[2] );
-                         p++;
-
-                         dst[1] += (levels[1] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                              levels[1] );
-                         p++;
-                    }
-
-                    if (FS_MODE_NUM_REARS( buffer->mode ) == 1) {
-                         __fsf s;
-
-                         s = FSF_FROM_SRC( src, p );
-                         p++;
-
-                         dst[3] += (levels[3] == FSF_ONE) ? s : fsf_mul( s, levels[3] );
-                         dst[4] += (levels[4] == FSF_ONE) ? s : fsf_mul( s, levels[4] );
-                    }
-                    else if (FS_MODE_NUM_REARS( buffer->mode ) == 2) {
-                         dst[3] += (levels[3] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                              levels[3] );
-                         p++;
-
-                         dst[4] += (levels[4] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                              levels[4] );
-                         p++;
-                    }
-
-                    if (FS_MODE_HAS_LFE( buffer->mode )) {
-                         dst[5] += (levels[5] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ),
-                                                                                              levels[5] );
-                    }
-               }
-
-               dst += FS_MAX_CHANNELS;
-          }
-
-          if (last)
-               max += FS_PITCH_ONE;
-     }
-#endif /* FS_LINEAR_FILTER */
-
-     for (; i > max; i += inc) {
-          long p = (i >> FS_PITCH_BITS) + pos;
-
-          if (p <= -buffer->length)
-               p %= buffer->length;
-          if (p < 0)
-               p += buffer->length;
-
-          p *= channels;
-
-          if (!FS_MODE_HAS_CENTER( buffer->mode )) {
-               __fsf sl, sr;
-
-               sl = (levels[0] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[0] );
-               p++;
-
-               sr = (levels[1] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[1] );
-               p++;
-
-               dst[0] += sl;
-               dst[1] += sr;
-               if (FS_MODE_HAS_CENTER( mode ))
-                    dst[2] += fsf_shr( sl + sr, 1 );
-          }
-          else {
-               dst[0] += (levels[0] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[0] );
-               p++;
-
-               dst[2] += (levels[2] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[2] );
-               p++;
-
-               dst[1] = (levels[1] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[1] );
-               p++;
-          }
-
-          if (FS_MODE_NUM_REARS( buffer->mode ) == 1) {
-               __fsf s;
-
-               s = FSF_FROM_SRC( src, p );
-               p++;
-
-               dst[3] += (levels[3] == FSF_ONE) ? s : fsf_mul( s, levels[3] );
-               dst[4] += (levels[4] == FSF_ONE) ? s : fsf_mul( s, levels[4] );
-          }
-          else if (FS_MODE_NUM_REARS( buffer->mode ) == 2) {
-               dst[3] += (levels[3] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[3] );
-               p++;
-
-               dst[4] += (levels[4] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[4] );
-               p++;
-          }
-
-          if (FS_MODE_HAS_LFE( buffer->mode )) {
-               dst[5] += (levels[5] == FSF_ONE) ? FSF_FROM_SRC( src, p ) : fsf_mul( FSF_FROM_SRC( src, p ), levels[5] );
-          }
-
-          dst += FS_MAX_CHANNELS;
-     }
-
-     return (dst - dest) / FS_MAX_CHANNELS;
-}
+#define LAYOUT      stereo21
+#define LAYOUT_MODE FS_CHANNELMODE( 3, 0, 0, 1 ) /* FSCM_STEREO21 */
+#include "sound_mix_layout.h"
+#undef  LAYOUT_MODE
+#undef  LAYOUT
+
+#define LAYOUT      stereo30
+#define LAYOUT_MODE FS_CHANNELMODE( 3, 1, 0, 0 ) /* FSCM_STEREO30 */
+#include "sound_mix_layout.h"
+#undef  LAYOUT_MODE
+#undef  LAYOUT
+
+#define LAYOUT      stereo31
+#define LAYOUT_MODE FS_CHANNELMODE( 3, 1, 0, 1 ) /* FSCM_STEREO31 */
+#include "sound_mix_layout.h"
+#undef  LAYOUT_MODE
+#undef  LAYOUT
+
+#define LAYOUT      surround30
+#define LAYOUT_MODE FS_CHANNELMODE( 3, 0, 1, 0 ) /* FSCM_SURROUND30 */
+#include "sound_mix_layout.h"
+#undef  LAYOUT_MODE
+#undef  LAYOUT
+
+#define LAYOUT      surround31
+#define LAYOUT_MODE FS_CHANNELMODE( 4, 0, 1, 1 ) /* FSCM_SURROUND31 */
+#include "sound_mix_layout.h"
+#undef  LAYOUT_MODE
+#undef  LAYOUT
+
+#define LAYOUT      surround40_2f2r
+#define LAYOUT_MODE FS_CHANNELMODE( 4, 0, 2, 0 ) /* FSCM_SURROUND40_2F2R */
+#include "sound_mix_layout.h"
+#undef  LAYOUT_MODE
+#undef  LAYOUT
+
+#define LAYOUT      surround41_2f2r
+#define LAYOUT_MODE FS_CHANNELMODE( 5, 0, 2, 1 ) /* FSCM_SURROUND41_2F2R */
+#include "sound_mix_layout.h"
+#undef  LAYOUT_MODE
+#undef  LAYOUT
+
+#define LAYOUT      surround40_3f1r
+#define LAYOUT_MODE FS_CHANNELMODE( 4, 1, 1, 0 ) /* FSCM_SURROUND40_3F1R */
+#include "sound_mix_layout.h"
+#undef  LAYOUT_MODE
+#undef  LAYOUT
+
+#define LAYOUT      surround41_3f1r
+#define LAYOUT_MODE FS_CHANNELMODE( 5, 1, 1, 1 ) /* FSCM_SURROUND41_3F1R */
+#include "sound_mix_layout.h"
+#undef  LAYOUT_MODE
+#undef  LAYOUT
+
+#define LAYOUT      surround50
+#define LAYOUT_MODE FS_CHANNELMODE( 5, 1, 2, 0 ) /* FSCM_SURROUND50 */
+#include "sound_mix_layout.h"
+#undef  LAYOUT_MODE
+#undef  LAYOUT
+
+#define LAYOUT      surround51
+#define LAYOUT_MODE FS_CHANNELMODE( 6, 1, 2, 1 ) /* FSCM_SURROUND51 */
+#include "sound_mix_layout.h"
+#undef  LAYOUT_MODE
+#undef  LAYOUT
 #endif /* FS_MAX_CHANNELS > 2 */
 
-#undef FSF_INTERP
+#undef MIX_FRAME
+#undef MIX_LFE
+#undef MIX_REAR
+#undef MIX_LEVEL
+
+#undef SIMD_FILTER
+#undef GEN_SIMD_FILTER
 
-#undef FUNC_NAME
-#undef GEN_FUNC_NAME
+#undef MIX_NAME
+#undef LAYOUT_MIX_NAME
+#undef GEN_MIX_NAME
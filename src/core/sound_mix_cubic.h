@@ -0,0 +1,106 @@
+/*
+   This file is part of DirectFB.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+/*
+ * Cubic Hermite (Catmull-Rom) kernels, interpolating between the two frames around the position using their outer
+ * neighbours as well.
+ */
+
+#define FSF_HERMITE( x0, x1, x2, x3, t )                                                             \
+__extension__( {                                                                                     \
+     register __fsf _c1 = fsf_shr( (x2) - (x0), 1 );                                                 \
+     register __fsf _c2 = (x0) - fsf_shr( 5 * (x1), 1 ) + fsf_shl( (x2), 1 ) - fsf_shr( (x3), 1 );   \
+     register __fsf _c3 = fsf_shr( (x3) - (x0), 1 ) + fsf_shr( 3 * ((x1) - (x2)), 1 );               \
+     fsf_mul( fsf_mul( fsf_mul( _c3, t ) + _c2, t ) + _c1, t ) + (x1);                               \
+} )
+
+/*
+ * Interpolate all channels of the frame at position 'i', 'p' being the frame index of the position.
+ */
+#define CUBIC_INTERP( values, p, i )                                                                 \
+     do {                                                                                            \
+          const TYPE *_s = src + ((p) - 1) * LAYOUT_CHANNELS;                                        \
+          __fsf       _t = fsf_from_int_scaled( (i) & (FS_PITCH_ONE - 1), FS_PITCH_BITS );           \
+          int         _c;                                                                            \
+                                                                                                     \
+          for (_c = 0; _c < LAYOUT_CHANNELS; _c++) {                                                 \
+               __fsf _x0 = FSF_FROM_SRC( _s, _c );                                                   \
+               __fsf _x1 = FSF_FROM_SRC( _s, _c + LAYOUT_CHANNELS );                                 \
+               __fsf _x2 = FSF_FROM_SRC( _s, _c + LAYOUT_CHANNELS * 2 );                             \
+               __fsf _x3 = FSF_FROM_SRC( _s, _c + LAYOUT_CHANNELS * 3 );                             \
+                                                                                                     \
+               (values)[_c] = FSF_HERMITE( _x0, _x1, _x2, _x3, _t );                                 \
+          }                                                                                          \
+     } while (0)
+
+static int
+MIX_NAME(fw,cubic) ( const void *data,
+                     __fsf      *dest[6],
+                     long        pos,
+                     long        i,
+                     long        inc,
+                     long        max,
+                     __fsf       levels[6],
+                     bool        last )
+{
+     const TYPE *src = data;
+     long        n   = 0;
+     __fsf       values[LAYOUT_CHANNELS];
+
+     for (; i < max; i += inc) {
+          long p = (i >> FS_PITCH_BITS) + pos;
+
+          CUBIC_INTERP( values, p, i );
+
+          MIX_FRAME( dest, n, values );
+
+          n++;
+     }
+
+     return n;
+}
+
+static int
+MIX_NAME(rw,cubic) ( const void *data,
+                     __fsf      *dest[6],
+                     long        pos,
+                     long        i,
+                     long        inc,
+                     long        max,
+                     __fsf       levels[6],
+                     bool        last )
+{
+     const TYPE *src = data;
+     long        n   = 0;
+     __fsf       values[LAYOUT_CHANNELS];
+
+     for (; i > max; i += inc) {
+          long p = (i >> FS_PITCH_BITS) + pos;
+
+          CUBIC_INTERP( values, p, i );
+
+          MIX_FRAME( dest, n, values );
+
+          n++;
+     }
+
+     return n;
+}
+
+#undef CUBIC_INTERP
+#undef FSF_HERMITE
@@ -0,0 +1,99 @@
+/*
+   This file is part of DirectFB.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+/*
+ * Mixing kernels of one layout, output and gain variant for each interpolation quality and, where vectorized, for
+ * each vector instruction set.
+ */
+
+#ifndef OUTPUT
+#warning OUTPUT is not defined!
+#endif
+
+#ifndef OUTPUT_CENTER
+#warning OUTPUT_CENTER is not defined!
+#endif
+
+#ifndef GAIN
+#warning GAIN is not defined!
+#endif
+
+#ifndef GAIN_UNITY
+#warning GAIN_UNITY is not defined!
+#endif
+
+/*
+ * Nearest sample (FSPQ_NONE) and linear interpolation (FSPQ_LINEAR) kernels.
+ */
+#define FILTER_NAME   none
+#define FILTER_LINEAR 0
+#include "sound_mix_scalar.h"
+#undef  FILTER_LINEAR
+#undef  FILTER_NAME
+
+#define FILTER_NAME   linear
+#define FILTER_LINEAR 1
+#include "sound_mix_scalar.h"
+#undef  FILTER_LINEAR
+#undef  FILTER_NAME
+
+/*
+ * Cubic Hermite interpolation (FSPQ_CUBIC) kernels.
+ */
+#include "sound_mix_cubic.h"
+
+/*
+ * Unity pitch (mono and stereo only) and windowed-sinc (FSPQ_SINC) kernels for each vector instruction set. SSE2
+ * kernels are not built if the baseline target has SSE2 already, as on x86-64.
+ */
+#define SIMD_NAME generic
+#define SIMD_VEC  __fsf_v4
+#define SIMD_ATTR
+#if LAYOUT_CHANNELS <= 2
+#include "sound_mix_unity.h"
+#endif
+#include "sound_mix_sinc.h"
+#undef  SIMD_ATTR
+#undef  SIMD_VEC
+#undef  SIMD_NAME
+
+#if FS_SIMD_X86
+#ifndef __SSE2__
+#define SIMD_NAME sse2
+#define SIMD_VEC  __fsf_v4
+#define SIMD_ATTR __attribute__((target("sse2")))
+#if LAYOUT_CHANNELS <= 2
+#include "sound_mix_unity.h"
+#endif
+#include "sound_mix_sinc.h"
+#undef  SIMD_ATTR
+#undef  SIMD_VEC
+#undef  SIMD_NAME
+#endif /* __SSE2__ */
+
+#define SIMD_NAME avx2
+#define SIMD_VEC  __fsf_v8
+#define SIMD_ATTR __attribute__((target("avx2")))
+#if LAYOUT_CHANNELS <= 2
+#include "sound_mix_unity.h"
+#endif
+#include "sound_mix_sinc.h"
+#undef  SIMD_ATTR
+#undef  SIMD_VEC
+#undef  SIMD_NAME
+#endif /* FS_SIMD_X86 */
@@ -0,0 +1,89 @@
+/*
+   This file is part of DirectFB.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+/*
+ * Mixing kernels for one source channel mode (LAYOUT and LAYOUT_MODE), for each output and gain variant.
+ *
+ * Kernels for a mixing buffer with center channel are not built if there can't be a center channel.
+ */
+
+#ifndef LAYOUT
+#warning LAYOUT is not defined!
+#endif
+
+#ifndef LAYOUT_MODE
+#warning LAYOUT_MODE is not defined!
+#endif
+
+#define LAYOUT_CHANNELS FS_CHANNELS_FOR_MODE( LAYOUT_MODE )
+
+/*
+ * Mixing buffer without center channel, arbitrary levels.
+ */
+#define OUTPUT        lr
+#define OUTPUT_CENTER 0
+#define GAIN          gain
+#define GAIN_UNITY    0
+#include "sound_mix_filters.h"
+#undef  GAIN_UNITY
+#undef  GAIN
+#undef  OUTPUT_CENTER
+#undef  OUTPUT
+
+/*
+ * Mixing buffer without center channel, all levels at FSF_ONE.
+ */
+#define OUTPUT        lr
+#define OUTPUT_CENTER 0
+#define GAIN          nogain
+#define GAIN_UNITY    1
+#include "sound_mix_filters.h"
+#undef  GAIN_UNITY
+#undef  GAIN
+#undef  OUTPUT_CENTER
+#undef  OUTPUT
+
+#if FS_MAX_CHANNELS > 2
+/*
+ * Mixing buffer with center channel, arbitrary levels.
+ */
+#define OUTPUT        lcr
+#define OUTPUT_CENTER 1
+#define GAIN          gain
+#define GAIN_UNITY    0
+#include "sound_mix_filters.h"
+#undef  GAIN_UNITY
+#undef  GAIN
+#undef  OUTPUT_CENTER
+#undef  OUTPUT
+
+/*
+ * Mixing buffer with center channel, all levels at FSF_ONE.
+ */
+#define OUTPUT        lcr
+#define OUTPUT_CENTER 1
+#define GAIN          nogain
+#define GAIN_UNITY    1
+#include "sound_mix_filters.h"
+#undef  GAIN_UNITY
+#undef  GAIN
+#undef  OUTPUT_CENTER
+#undef  OUTPUT
+#endif /* FS_MAX_CHANNELS > 2 */
+
+#undef LAYOUT_CHANNELS
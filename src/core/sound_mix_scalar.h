@@ -0,0 +1,157 @@
+/*
+   This file is part of DirectFB.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+/*
+ * Nearest sample kernels, using linear interpolation for upsampling if FILTER_LINEAR is set.
+ *
+ * Like all kernels, they are given runs that stay within the source data including the interpolation neighbours
+ * (see fs_buffer_mixto()), the starting position being 'pos' plus the fraction 'i'.
+ */
+
+#ifndef FILTER_NAME
+#warning FILTER_NAME is not defined!
+#endif
+
+#ifndef FILTER_LINEAR
+#warning FILTER_LINEAR is not defined!
+#endif
+
+#define FSF_INTERP( a, b, w )    \
+__extension__( {                 \
+     register __fsf _a = (a);    \
+     register __fsf _b = (b);    \
+     _a + fsf_mul( _b - _a, w ); \
+} )
+
+/*
+ * Interpolate all channels of the frame at position 'i' between frame 'p' and the following frame 'q'.
+ */
+#define LINEAR_INTERP( values, p, q, i )                                                             \
+     do {                                                                                            \
+          __fsf _w = fsf_from_int_scaled( (i) & (FS_PITCH_ONE - 1), FS_PITCH_BITS );                 \
+          int   _c;                                                                                  \
+                                                                                                     \
+          for (_c = 0; _c < LAYOUT_CHANNELS; _c++)                                                   \
+               (values)[_c] = FSF_INTERP( FSF_FROM_SRC( src, (p) * LAYOUT_CHANNELS + _c ),           \
+                                          FSF_FROM_SRC( src, (q) * LAYOUT_CHANNELS + _c ), _w );     \
+     } while (0)
+
+/*
+ * Fetch all channels of frame 'p'.
+ */
+#define NEAREST_FETCH( values, p )                                                                   \
+     do {                                                                                            \
+          int _c;                                                                                    \
+                                                                                                     \
+          for (_c = 0; _c < LAYOUT_CHANNELS; _c++)                                                   \
+               (values)[_c] = FSF_FROM_SRC( src, (p) * LAYOUT_CHANNELS + _c );                       \
+     } while (0)
+
+static int
+MIX_NAME(fw,FILTER_NAME) ( const void *data,
+                           __fsf      *dest[6],
+                           long        pos,
+                           long        i,
+                           long        inc,
+                           long        max,
+                           __fsf       levels[6],
+                           bool        last )
+{
+     const TYPE *src = data;
+     long        n   = 0;
+     __fsf       values[LAYOUT_CHANNELS];
+
+#if FILTER_LINEAR
+     if (inc < FS_PITCH_ONE) {
+          /* upsample */
+          if (last)
+               max -= FS_PITCH_ONE;
+
+          for (; i < max; i += inc) {
+               long p = (i >> FS_PITCH_BITS) + pos;
+
+               LINEAR_INTERP( values, p, p + 1, i );
+
+               MIX_FRAME( dest, n, values );
+
+               n++;
+          }
+
+          if (last)
+               max += FS_PITCH_ONE;
+     }
+#endif /* FILTER_LINEAR */
+
+     for (; i < max; i += inc) {
+          long p = (i >> FS_PITCH_BITS) + pos;
+
+          NEAREST_FETCH( values, p );
+
+          MIX_FRAME( dest, n, values );
+
+          n++;
+     }
+
+     return n;
+}
+
+static int
+MIX_NAME(rw,FILTER_NAME) ( const void *data,
+                           __fsf      *dest[6],
+                           long        pos,
+                           long        i,
+                           long        inc,
+                           long        max,
+                           __fsf       levels[6],
+                           bool        last )
+{
+     const TYPE *src = data;
+     long        n   = 0;
+     __fsf       values[LAYOUT_CHANNELS];
+
+#if FILTER_LINEAR
+     if (-inc < FS_PITCH_ONE) {
+          /* upsample, the following frame has already been played, no need to stop early */
+          for (; i > max; i += inc) {
+               long p = (i >> FS_PITCH_BITS) + pos;
+
+               LINEAR_INTERP( values, p, p + 1, i );
+
+               MIX_FRAME( dest, n, values );
+
+               n++;
+          }
+     }
+#endif /* FILTER_LINEAR */
+
+     for (; i > max; i += inc) {
+          long p = (i >> FS_PITCH_BITS) + pos;
+
+          NEAREST_FETCH( values, p );
+
+          MIX_FRAME( dest, n, values );
+
+          n++;
+     }
+
+     return n;
+}
+
+#undef NEAREST_FETCH
+#undef LINEAR_INTERP
+#undef FSF_INTERP
@@ -0,0 +1,163 @@
+/*
+   This file is part of DirectFB.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+/*
+ * Windowed-sinc kernels (see sound_sinc.h).
+ *
+ * Source frames are converted block-wise into one plane per channel, so that the taps of each output sample are
+ * contiguous in memory. Frames across the end of the buffer, e.g. the previous data of a stream's ring buffer being
+ * seen as history, are provided by fs_buffer_mixto() which limits the kernels to runs with all taps available.
+ */
+
+#define SINC_FILTER SIMD_FILTER( sinc, SIMD_NAME )
+
+#define GEN_SINC_DOT( simd ) fs_sinc_dot_##simd
+#define SIMD_SINC_DOT( simd ) GEN_SINC_DOT( simd )
+#define SINC_DOT SIMD_SINC_DOT( SIMD_NAME )
+
+#ifndef SIMD_NAME
+#warning SIMD_NAME is not defined!
+#endif
+
+#ifndef SIMD_ATTR
+#warning SIMD_ATTR is not defined!
+#endif
+
+/* Number of frames per plane. */
+#define SINC_FRAMES (FS_SIMD_BLOCK + FS_SINC_TAPS)
+
+/*
+ * Convert 'num' frames starting at frame 'first'.
+ */
+static inline SIMD_ATTR void
+MIX_NAME(fill,SINC_FILTER) ( const TYPE *src,
+                             __fsf       planes[][SINC_FRAMES],
+                             long        first,
+                             long        num )
+{
+     long i, c;
+
+     src += first * LAYOUT_CHANNELS;
+
+     for (i = 0; i < num; i++) {
+          for (c = 0; c < LAYOUT_CHANNELS; c++)
+               planes[c][i] = FSF_FROM_SRC( src, c );
+
+          src += LAYOUT_CHANNELS;
+     }
+}
+
+/*
+ * Interpolate all channels of the frame at position 'i', 'k' being the plane index of the first tap.
+ */
+#define SINC_INTERP( values, planes, k, i )                                            \
+     do {                                                                              \
+          const __fsf *_coefs = fs_sinc_table[FS_SINC_PHASE( i )];                     \
+          int          _c;                                                             \
+                                                                                       \
+          for (_c = 0; _c < LAYOUT_CHANNELS; _c++)                                     \
+               (values)[_c] = SINC_DOT( (planes)[_c] + (k), _coefs );                  \
+     } while (0)
+
+/*
+ * Forward and reverse kernels, converting a new block whenever the taps of the next frame leave the current one.
+ */
+static SIMD_ATTR int
+MIX_NAME(fw,SINC_FILTER) ( const void *data,
+                           __fsf      *dest[6],
+                           long        pos,
+                           long        i,
+                           long        inc,
+                           long        max,
+                           __fsf       levels[6],
+                           bool        last )
+{
+     const TYPE *src = data;
+     long        n   = 0;
+     __fsf       planes[LAYOUT_CHANNELS][SINC_FRAMES];
+     __fsf       values[LAYOUT_CHANNELS];
+
+     while (i < max) {
+          long first = (i >> FS_PITCH_BITS) + pos - (FS_SINC_TAPS / 2 - 1);
+          long num   = MIN( ((max - 1) >> FS_PITCH_BITS) - (i >> FS_PITCH_BITS) + FS_SINC_TAPS, SINC_FRAMES );
+
+          MIX_NAME(fill,SINC_FILTER)( src, planes, first, num );
+
+          for (; i < max; i += inc) {
+               long k = (i >> FS_PITCH_BITS) + pos - (FS_SINC_TAPS / 2 - 1) - first;
+
+               if (k + FS_SINC_TAPS > num)
+                    break;
+
+               SINC_INTERP( values, planes, k, i );
+
+               MIX_FRAME( dest, n, values );
+
+               n++;
+          }
+     }
+
+     return n;
+}
+
+static SIMD_ATTR int
+MIX_NAME(rw,SINC_FILTER) ( const void *data,
+                           __fsf      *dest[6],
+                           long        pos,
+                           long        i,
+                           long        inc,
+                           long        max,
+                           __fsf       levels[6],
+                           bool        last )
+{
+     const TYPE *src = data;
+     long        n   = 0;
+     __fsf       planes[LAYOUT_CHANNELS][SINC_FRAMES];
+     __fsf       values[LAYOUT_CHANNELS];
+
+     while (i > max) {
+          long num   = MIN( (i >> FS_PITCH_BITS) - ((max + 1) >> FS_PITCH_BITS) + FS_SINC_TAPS, SINC_FRAMES );
+          long first = (i >> FS_PITCH_BITS) + pos + FS_SINC_TAPS / 2 - num + 1;
+
+          MIX_NAME(fill,SINC_FILTER)( src, planes, first, num );
+
+          for (; i > max; i += inc) {
+               long k = (i >> FS_PITCH_BITS) + pos - (FS_SINC_TAPS / 2 - 1) - first;
+
+               if (k < 0)
+                    break;
+
+               SINC_INTERP( values, planes, k, i );
+
+               MIX_FRAME( dest, n, values );
+
+               n++;
+          }
+     }
+
+     return n;
+}
+
+#undef SINC_INTERP
+#undef SINC_FRAMES
+
+#undef SINC_DOT
+#undef SIMD_SINC_DOT
+#undef GEN_SINC_DOT
+
+#undef SINC_FILTER
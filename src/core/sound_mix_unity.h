@@ -0,0 +1,232 @@
+/*
+   This file is part of DirectFB.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+/*
+ * Unity pitch kernels (inc == +/-FS_PITCH_ONE) for mono and stereo sources.
+ *
+ * Source frames are converted, scaled and accumulated into the mixing buffer a vector at a time, remaining frames are
+ * mixed one by one. Runs never cross the end of the buffer (see fs_buffer_mixto()).
+ */
+
+#define UNITY_FILTER SIMD_FILTER( unity, SIMD_NAME )
+
+#ifndef SIMD_NAME
+#warning SIMD_NAME is not defined!
+#endif
+
+#ifndef SIMD_VEC
+#warning SIMD_VEC is not defined!
+#endif
+
+#ifndef SIMD_ATTR
+#warning SIMD_ATTR is not defined!
+#endif
+
+#define SIMD_LANES (int) (sizeof(SIMD_VEC) / sizeof(__fsf))
+
+/*
+ * Mixing buffer planes, vector type for unaligned access to them, lane selection masks and level vectors. Lanes are
+ * selected from the converted samples in reverse order for 'rw' kernels, stereo samples are split by the masks.
+ */
+#define UNITY_SETUP( rw )                                                              \
+     typedef SIMD_VEC  unity_vec  __attribute__((aligned(sizeof(__fsf)), may_alias));  \
+     typedef s32       unity_mask __attribute__((vector_size(sizeof(SIMD_VEC))));      \
+     __fsf            *dl = dest[0];                                                   \
+     __fsf            *dr = dest[1];                                                   \
+     __fsf            *dc = dest[2];                                                   \
+     unity_mask        ml;                                                             \
+     SIMD_VEC          gl, gr, ul, ur;                                                 \
+     UNITY_MASK_RIGHT                                                                  \
+                                                                                       \
+     for (j = 0; j < SIMD_LANES; j++) {                                                \
+          ml[j] = ((rw) ? SIMD_LANES - 1 - j : j) * LAYOUT_CHANNELS;                   \
+          UNITY_MASK_SET( j );                                                         \
+                                                                                       \
+          fsf_vec_level( gl, ul, j, levels[0] );                                       \
+          fsf_vec_level( gr, ur, j, levels[1] );                                       \
+     }
+
+#if LAYOUT_CHANNELS == 1
+#define UNITY_MASK_RIGHT
+#define UNITY_MASK_SET( j ) do {} while (0)
+#else
+#define UNITY_MASK_RIGHT    unity_mask mr;
+#define UNITY_MASK_SET( j ) mr[j] = ml[j] + 1
+#endif
+
+/*
+ * Convert the samples at 's' into a vector, widening them with vector operations where the format provides them.
+ */
+#ifdef FSF_VEC_FROM_SRC
+#define UNITY_CONVERT( v, s )                                                          \
+     do {                                                                              \
+          typedef TYPE _src __attribute__((vector_size(SIMD_LANES * sizeof(TYPE)),    \
+                                           aligned(sizeof(TYPE)), may_alias));         \
+                                                                                       \
+          (v) = FSF_VEC_FROM_SRC( *(const _src*) (s), SIMD_VEC );                      \
+     } while (0)
+#else
+#define UNITY_CONVERT( v, s )                                                          \
+     do {                                                                              \
+          int _j;                                                                      \
+                                                                                       \
+          for (_j = 0; _j < SIMD_LANES; _j++)                                          \
+               (v)[_j] = FSF_FROM_SRC( (s), _j );                                      \
+     } while (0)
+#endif
+
+/*
+ * Convert and scale the frames of one vector starting at 's' into the left and right vectors 'l' and 'r'.
+ * Mono samples are scaled into both vectors, stereo samples are split into the vectors.
+ */
+#if LAYOUT_CHANNELS == 1
+#define UNITY_VECTOR( s, rw, l, r )                                                    \
+     do {                                                                              \
+          UNITY_CONVERT( l, s );                                                       \
+                                                                                       \
+          if (rw)                                                                      \
+               (l) = __builtin_shuffle( (l), ml );                                     \
+                                                                                       \
+          if (!GAIN_UNITY) {                                                           \
+               (r) = fsf_vec_mul( (l), gr, ur );                                       \
+               (l) = fsf_vec_mul( (l), gl, ul );                                       \
+          }                                                                            \
+          else                                                                         \
+               (r) = (l);                                                              \
+     } while (0)
+#else
+#define UNITY_VECTOR( s, rw, l, r )                                                    \
+     do {                                                                              \
+          SIMD_VEC _a, _b;                                                             \
+                                                                                       \
+          UNITY_CONVERT( _a, s );                                                      \
+          UNITY_CONVERT( _b, (s) + SIMD_LANES );                                       \
+                                                                                       \
+          (l) = __builtin_shuffle( _a, _b, ml );                                       \
+          (r) = __builtin_shuffle( _a, _b, mr );                                       \
+                                                                                       \
+          if (!GAIN_UNITY) {                                                           \
+               (l) = fsf_vec_mul( (l), gl, ul );                                       \
+               (r) = fsf_vec_mul( (r), gr, ur );                                       \
+          }                                                                            \
+     } while (0)
+#endif
+
+/*
+ * Accumulate the left and right vectors into the mixing buffer planes starting at frame 'n'.
+ */
+#define UNITY_ADD( l, r, n )                                                           \
+     do {                                                                              \
+          *(unity_vec*) (dl + (n)) += (l);                                             \
+          *(unity_vec*) (dr + (n)) += (r);                                             \
+          if (OUTPUT_CENTER)                                                           \
+               *(unity_vec*) (dc + (n)) += fsf_shr( (l) + (r), 1 );                    \
+     } while (0)
+
+/*
+ * Accumulate the frame at 's' into frame 'n' of the mixing buffer planes.
+ */
+#define UNITY_FRAME( s, n )                                                            \
+     do {                                                                              \
+          __fsf _l = MIX_LEVEL( FSF_FROM_SRC( (s), 0 ), levels[0] );                   \
+          __fsf _r = MIX_LEVEL( FSF_FROM_SRC( (s), LAYOUT_CHANNELS - 1 ), levels[1] ); \
+                                                                                       \
+          dl[n] += _l;                                                                 \
+          dr[n] += _r;                                                                 \
+          if (OUTPUT_CENTER)                                                           \
+               dc[n] += fsf_shr( _l + _r, 1 );                                         \
+     } while (0)
+
+static SIMD_ATTR int
+MIX_NAME(fw,UNITY_FILTER) ( const void *data,
+                            __fsf      *dest[6],
+                            long        pos,
+                            long        i,
+                            long        inc,
+                            long        max,
+                            __fsf       levels[6],
+                            bool        last )
+{
+     long        j;
+     long        n   = 0;
+     long        num = (max - i + FS_PITCH_ONE - 1) >> FS_PITCH_BITS;
+     const TYPE *src = (const TYPE*) data + pos * LAYOUT_CHANNELS;
+     UNITY_SETUP( 0 )
+
+     for (; n + SIMD_LANES <= num; n += SIMD_LANES) {
+          SIMD_VEC l, r;
+
+          UNITY_VECTOR( src, 0, l, r );
+          UNITY_ADD( l, r, n );
+
+          src += SIMD_LANES * LAYOUT_CHANNELS;
+     }
+
+     for (; n < num; n++) {
+          UNITY_FRAME( src, n );
+
+          src += LAYOUT_CHANNELS;
+     }
+
+     return n;
+}
+
+static SIMD_ATTR int
+MIX_NAME(rw,UNITY_FILTER) ( const void *data,
+                            __fsf      *dest[6],
+                            long        pos,
+                            long        i,
+                            long        inc,
+                            long        max,
+                            __fsf       levels[6],
+                            bool        last )
+{
+     long        j;
+     long        n   = 0;
+     long        num = (i - max + FS_PITCH_ONE - 1) >> FS_PITCH_BITS;
+     const TYPE *src = (const TYPE*) data + (pos + 1) * LAYOUT_CHANNELS;
+     UNITY_SETUP( 1 )
+
+     for (; n + SIMD_LANES <= num; n += SIMD_LANES) {
+          SIMD_VEC l, r;
+
+          src -= SIMD_LANES * LAYOUT_CHANNELS;
+
+          UNITY_VECTOR( src, 1, l, r );
+          UNITY_ADD( l, r, n );
+     }
+
+     for (; n < num; n++) {
+          src -= LAYOUT_CHANNELS;
+
+          UNITY_FRAME( src, n );
+     }
+
+     return n;
+}
+
+#undef UNITY_FRAME
+#undef UNITY_ADD
+#undef UNITY_VECTOR
+#undef UNITY_CONVERT
+#undef UNITY_MASK_SET
+#undef UNITY_MASK_RIGHT
+#undef UNITY_SETUP
+#undef SIMD_LANES
+
+#undef UNITY_FILTER
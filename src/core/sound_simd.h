@@ -0,0 +1,223 @@
+/*
+   This file is part of DirectFB.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#ifndef __CORE__SOUND_SIMD_H__
+#define __CORE__SOUND_SIMD_H__
+
+#include <core/coretypes_sound.h>
+#include <core/fs_types.h>
+
+/**********************************************************************************************************************/
+
+/*
+ * Vector instruction sets the mixing kernels are built for.
+ */
+typedef enum {
+     FS_SIMD_GENERIC = 0, /* GCC vector extensions, lowered for the baseline target */
+     FS_SIMD_SSE2    = 1, /* x86 SSE2 */
+     FS_SIMD_AVX2    = 2, /* x86 AVX2 */
+
+     FS_SIMD_NUM     = 3
+} FSSimdLevel;
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define FS_SIMD_X86 1
+#else
+#define FS_SIMD_X86 0
+#endif
+
+#if FS_SIMD_X86
+#include <immintrin.h>
+#endif
+
+/* Number of samples converted per block by the vector kernels. */
+#define FS_SIMD_BLOCK 256
+
+/*
+ * Vectors of __fsf (16 and 32 bytes).
+ */
+typedef __fsf __fsf_v4 __attribute__((vector_size(16)));
+typedef __fsf __fsf_v8 __attribute__((vector_size(32)));
+
+/*
+ * Per lane volume level preparation and multiplication, matching fsf_mul() including the unity level shortcut, and
+ * conversion of a vector of source samples to a vector of type 'V', matching fsf_from_u8() etc.
+ */
+#ifdef FS_IEEE_FLOATS
+
+#define fsf_vec_level( g, u, j, level ) \
+     do {                               \
+          (g)[j] = (level);             \
+          (u)[j] = 0;                   \
+     } while (0)
+
+#define fsf_vec_mul( v, g, u )          ((void) (u), (v) * (g))
+
+#define fsf_vec_from_u8( v, V )         ((__builtin_convertvector( v, V ) - 128.0f) / 128.0f)
+#define fsf_vec_from_s16( v, V )        (__builtin_convertvector( v, V ) / 32768.0f)
+#define fsf_vec_from_s32( v, V )        (__builtin_convertvector( v, V ) / 2147483648.0f)
+#define fsf_vec_from_float( v, V )      __builtin_convertvector( v, V )
+
+#else /* FS_IEEE_FLOATS */
+
+#define fsf_vec_level( g, u, j, level )                \
+     do {                                              \
+          (g)[j] = (level) >> 15;                      \
+          (u)[j] = ((level) == FSF_ONE) ? ~0 : 0;      \
+     } while (0)
+
+#define fsf_vec_mul( v, g, u )          (((((v) >> (FSF_DECIBITS - 15)) * (g)) & ~(u)) | ((v) & (u)))
+
+#define fsf_vec_from_u8( v, V )         ((__builtin_convertvector( v, V ) - 128) << (FSF_DECIBITS - 7))
+#define fsf_vec_from_s16( v, V )        (__builtin_convertvector( v, V ) << (FSF_DECIBITS - 15))
+#define fsf_vec_from_s32( v, V )        (__builtin_convertvector( v, V ) >> (31 - FSF_DECIBITS))
+#define fsf_vec_from_float( v, V )      __builtin_convertvector( (v) * (float) FSF_ONE, V )
+
+#endif /* FS_IEEE_FLOATS */
+
+#if FS_SIMD_X86
+
+/*
+ * Scale samples for a saturating pack to 'bits' (8 or 16), the result of the pack being identical to fsf_clip()
+ * followed by fsf_to_u8() (biased by -128) or fsf_to_s16().
+ */
+static inline __attribute__((target("sse2"))) __m128i
+fs_simd_scale_sse2( const __fsf *src,
+                    int          bits )
+{
+#ifdef FS_IEEE_FLOATS
+     __m128 v = _mm_loadu_ps( src );
+
+     /* Float conversion does not saturate, clip first. */
+     v = _mm_min_ps( _mm_max_ps( v, _mm_set1_ps( FSF_MIN ) ), _mm_set1_ps( FSF_MAX ) );
+
+     if (bits == 8)
+          return _mm_sub_epi32( _mm_cvttps_epi32( _mm_add_ps( _mm_mul_ps( v, _mm_set1_ps( 128.0f ) ),
+                                                              _mm_set1_ps( 128.0f ) ) ), _mm_set1_epi32( 128 ) );
+
+     return _mm_cvttps_epi32( _mm_mul_ps( v, _mm_set1_ps( 32768.0f ) ) );
+#else
+     return _mm_srai_epi32( _mm_loadu_si128( (const __m128i*) src ), FSF_DECIBITS + 1 - bits );
+#endif
+}
+
+static inline __attribute__((target("avx2"))) __m256i
+fs_simd_scale_avx2( const __fsf *src,
+                    int          bits )
+{
+#ifdef FS_IEEE_FLOATS
+     __m256 v = _mm256_loadu_ps( src );
+
+     /* Float conversion does not saturate, clip first. */
+     v = _mm256_min_ps( _mm256_max_ps( v, _mm256_set1_ps( FSF_MIN ) ), _mm256_set1_ps( FSF_MAX ) );
+
+     if (bits == 8)
+          return _mm256_sub_epi32( _mm256_cvttps_epi32( _mm256_add_ps( _mm256_mul_ps( v, _mm256_set1_ps( 128.0f ) ),
+                                                                       _mm256_set1_ps( 128.0f ) ) ),
+                                   _mm256_set1_epi32( 128 ) );
+
+     return _mm256_cvttps_epi32( _mm256_mul_ps( v, _mm256_set1_ps( 32768.0f ) ) );
+#else
+     return _mm256_srai_epi32( _mm256_loadu_si256( (const __m256i*) src ), FSF_DECIBITS + 1 - bits );
+#endif
+}
+
+/*
+ * Convert 8 samples to signed 16 bit.
+ */
+static inline __attribute__((target("sse2"))) void
+fs_simd_s16_sse2( const __fsf *src,
+                  u8          *dst )
+{
+     _mm_storeu_si128( (__m128i*) dst, _mm_packs_epi32( fs_simd_scale_sse2( src, 16 ),
+                                                        fs_simd_scale_sse2( src + 4, 16 ) ) );
+}
+
+/*
+ * Convert 16 samples to unsigned 8 bit.
+ */
+static inline __attribute__((target("sse2"))) void
+fs_simd_u8_sse2( const __fsf *src,
+                 u8          *dst )
+{
+     __m128i a = _mm_packs_epi32( fs_simd_scale_sse2( src,     8 ), fs_simd_scale_sse2( src + 4,  8 ) );
+     __m128i b = _mm_packs_epi32( fs_simd_scale_sse2( src + 8, 8 ), fs_simd_scale_sse2( src + 12, 8 ) );
+
+     _mm_storeu_si128( (__m128i*) dst, _mm_xor_si128( _mm_packs_epi16( a, b ), _mm_set1_epi8( (char) 0x80 ) ) );
+}
+
+/*
+ * Convert 16 samples to signed 16 bit, packs work within 128 bit lanes and need to be reordered.
+ */
+static inline __attribute__((target("avx2"))) void
+fs_simd_s16_avx2( const __fsf *src,
+                  u8          *dst )
+{
+     __m256i v = _mm256_packs_epi32( fs_simd_scale_avx2( src, 16 ), fs_simd_scale_avx2( src + 8, 16 ) );
+
+     _mm256_storeu_si256( (__m256i*) dst, _mm256_permute4x64_epi64( v, 0xd8 ) );
+}
+
+/*
+ * Convert 32 samples to unsigned 8 bit.
+ */
+static inline __attribute__((target("avx2"))) void
+fs_simd_u8_avx2( const __fsf *src,
+                 u8          *dst )
+{
+     __m256i a = _mm256_packs_epi32( fs_simd_scale_avx2( src,      8 ), fs_simd_scale_avx2( src + 8,  8 ) );
+     __m256i b = _mm256_packs_epi32( fs_simd_scale_avx2( src + 16, 8 ), fs_simd_scale_avx2( src + 24, 8 ) );
+     __m256i v;
+
+     v = _mm256_packs_epi16( _mm256_permute4x64_epi64( a, 0xd8 ), _mm256_permute4x64_epi64( b, 0xd8 ) );
+
+     _mm256_storeu_si256( (__m256i*) dst, _mm256_xor_si256( _mm256_permute4x64_epi64( v, 0xd8 ),
+                                                             _mm256_set1_epi8( (char) 0x80 ) ) );
+}
+
+#endif /* FS_SIMD_X86 */
+
+/**********************************************************************************************************************/
+
+/*
+ * Returns the best vector instruction set supported by the CPU.
+ */
+static inline FSSimdLevel
+fs_simd_level( void )
+{
+#if FS_SIMD_X86
+     static int level = -1;
+
+     if (level < 0) {
+          __builtin_cpu_init();
+
+          if (__builtin_cpu_supports( "avx2" ))
+               level = FS_SIMD_AVX2;
+          else if (__builtin_cpu_supports( "sse2" ))
+               level = FS_SIMD_SSE2;
+          else
+               level = FS_SIMD_GENERIC;
+     }
+
+     return level;
+#else
+     return FS_SIMD_GENERIC;
+#endif
+}
+
+#endif
@@ -0,0 +1,71 @@
+/*
+   This file is part of DirectFB.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include <core/sound_sinc.h>
+#include <math.h>
+
+D_DEBUG_DOMAIN( CoreSound_Sinc, "CoreSound/Sinc", "FusionSound Core Sinc Filter" );
+
+/**********************************************************************************************************************/
+
+/* Cutoff relative to the source Nyquist frequency, leaving room for the transition band of the short filter. */
+#define SINC_CUTOFF 0.92
+
+__fsf fs_sinc_table[FS_SINC_PHASES][FS_SINC_TAPS] __attribute__((aligned(32)));
+
+static bool sinc_initialized = false;
+
+void
+fs_sinc_init()
+{
+     int p, t;
+
+     if (sinc_initialized)
+          return;
+
+     D_DEBUG_AT( CoreSound_Sinc, "%s()\n", __FUNCTION__ );
+
+     for (p = 0; p < FS_SINC_PHASES; p++) {
+          double h[FS_SINC_TAPS];
+          double sum = 0;
+
+          for (t = 0; t < FS_SINC_TAPS; t++) {
+               /* Distance of the tap from the interpolation point. */
+               double d = t - (FS_SINC_TAPS / 2 - 1) - (double) p / FS_SINC_PHASES;
+               double x = M_PI * SINC_CUTOFF * d;
+               double w = 2 * M_PI * d / FS_SINC_TAPS;
+
+               /* Blackman window centered on the interpolation point. */
+               h[t]  = (x != 0) ? sin( x ) / x : 1;
+               h[t] *= 0.42 + 0.5 * cos( w ) + 0.08 * cos( 2 * w );
+
+               sum += h[t];
+          }
+
+          /* Normalize for unity gain at DC. */
+          for (t = 0; t < FS_SINC_TAPS; t++) {
+#ifdef FS_IEEE_FLOATS
+               fs_sinc_table[p][t] = h[t] / sum;
+#else
+               fs_sinc_table[p][t] = lrint( h[t] / sum * (1 << FS_SINC_BITS) );
+#endif
+          }
+     }
+
+     sinc_initialized = true;
+}
@@ -0,0 +1,122 @@
+/*
+   This file is part of DirectFB.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#ifndef __CORE__SOUND_SINC_H__
+#define __CORE__SOUND_SINC_H__
+
+#include <core/sound_simd.h>
+
+/**********************************************************************************************************************/
+
+/*
+ * Polyphase windowed-sinc interpolation.
+ *
+ * Each output sample is the dot product of FS_SINC_TAPS source frames around the interpolation point with the
+ * coefficients of the phase selected by the upper bits of the FS_PITCH_BITS fractional position.
+ */
+#define FS_SINC_TAPS         16
+#define FS_SINC_PHASE_BITS   8
+#define FS_SINC_PHASES       (1 << FS_SINC_PHASE_BITS)
+
+/* Number of fractional bits of fixed point coefficients. */
+#define FS_SINC_BITS         14
+
+/* Phase for a pitch position. */
+#define FS_SINC_PHASE( i )   (((i) & (FS_PITCH_ONE - 1)) >> (FS_PITCH_BITS - FS_SINC_PHASE_BITS))
+
+extern __fsf fs_sinc_table[FS_SINC_PHASES][FS_SINC_TAPS];
+
+/*
+ * Build the coefficient tables.
+ */
+void fs_sinc_init( void );
+
+/**********************************************************************************************************************/
+
+/*
+ * Product of a sample and a coefficient, and conversion of the sum of products back to a sample. Fixed point samples
+ * are reduced to 15 bits, so that the sum of products stays within 32 bits.
+ */
+#ifdef FS_IEEE_FLOATS
+#define fsf_sinc_mul( s, c )  ((s) * (c))
+#define fsf_sinc_sum( x )     (x)
+#else
+#define fsf_sinc_mul( s, c )  (((s) >> (FSF_DECIBITS - 15)) * (c))
+#define fsf_sinc_sum( x )     ((x) >> (15 + FS_SINC_BITS - FSF_DECIBITS))
+#endif
+
+/*
+ * Vectors of __fsf for unaligned source samples.
+ */
+typedef __fsf __fsf_v4u __attribute__((vector_size(16), aligned(sizeof(__fsf))));
+typedef __fsf __fsf_v8u __attribute__((vector_size(32), aligned(sizeof(__fsf))));
+
+static inline __fsf
+fs_sinc_dot_generic( const __fsf *s,
+                     const __fsf *c )
+{
+     int      i;
+     __fsf    sum = 0;
+     __fsf_v4 acc = { 0 };
+
+     for (i = 0; i < FS_SINC_TAPS; i += 4)
+          acc += fsf_sinc_mul( *(const __fsf_v4u*) (s + i), *(const __fsf_v4*) (c + i) );
+
+     for (i = 0; i < 4; i++)
+          sum += acc[i];
+
+     return fsf_sinc_sum( sum );
+}
+
+#if FS_SIMD_X86
+static inline __attribute__((target("sse2"))) __fsf
+fs_sinc_dot_sse2( const __fsf *s,
+                  const __fsf *c )
+{
+     int      i;
+     __fsf    sum = 0;
+     __fsf_v4 acc = { 0 };
+
+     for (i = 0; i < FS_SINC_TAPS; i += 4)
+          acc += fsf_sinc_mul( *(const __fsf_v4u*) (s + i), *(const __fsf_v4*) (c + i) );
+
+     for (i = 0; i < 4; i++)
+          sum += acc[i];
+
+     return fsf_sinc_sum( sum );
+}
+
+static inline __attribute__((target("avx2"))) __fsf
+fs_sinc_dot_avx2( const __fsf *s,
+                  const __fsf *c )
+{
+     int      i;
+     __fsf    sum = 0;
+     __fsf_v8 acc = { 0 };
+
+     for (i = 0; i < FS_SINC_TAPS; i += 8)
+          acc += fsf_sinc_mul( *(const __fsf_v8u*) (s + i), *(const __fsf_v8*) (c + i) );
+
+     for (i = 0; i < 8; i++)
+          sum += acc[i];
+
+     return fsf_sinc_sum( sum );
+}
+#endif /* FS_SIMD_X86 */
+
+#endif
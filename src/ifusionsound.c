@@ -19,11 +19,13 @@
 #include <buffer/ifusionsoundbuffer.h>
 #include <buffer/ifusionsoundstream.h>
 #include <core/core_sound.h>
+#include <core/playback.h>
 #include <core/sound_buffer.h>
 #include <core/sound_device.h>
 #include <fusionsound_util.h>
 #include <ifusionsound.h>
 #include <media/ifusionsoundmusicprovider.h>
+#include <playback/ifusionsoundplayback.h>
 
 D_DEBUG_DOMAIN( FusionSound, "IFusionSound", "IFusionSound Interface" );
 
@@ -196,7 +198,7 @@ IFusionSound_CreateBuffer( IFusionSound               *thiz,
      if (length > FS_MAX_FRAMES)
           return DR_LIMITEXCEEDED;
 
-     ret = fs_buffer_create( data->core, length, mode, format, rate, &buffer );
+     ret = fs_buffer_create( data->core, length, mode, format, rate, false, &buffer );
      if (ret)
           return ret;
 
@@ -226,6 +228,9 @@ IFusionSound_CreateStream( IFusionSound               *thiz,
      IFusionSoundStream    *iface;
      int                    buffersize = 0;
      int                    prebuffer  = 0;
+     FSStreamCapabilities   caps       = FSSCAPS_NONE;
+     FSStreamCallback       callback   = NULL;
+     void                  *ctx        = NULL;
 
      DIRECT_INTERFACE_GET_DATA( IFusionSound )
 
@@ -314,6 +319,22 @@ IFusionSound_CreateStream( IFusionSound               *thiz,
 
                prebuffer = desc->prebuffer;
           }
+
+          if (desc->flags & FSSDF_CAPS) {
+               if (desc->caps & ~FSSCAPS_ALL)
+                    return DR_INVARG;
+
+               caps = desc->caps;
+
+               if (caps & FSSCAPS_CALLBACK) {
+                    if (!desc->callback)
+                         return DR_INVARG;
+
+                    caps     |= FSSCAPS_RING;
+                    callback  = desc->callback;
+                    ctx       = desc->callback_ctx;
+               }
+          }
      }
 
      /* Default ring buffer size is 200 milliseconds. */
@@ -324,13 +345,14 @@ IFusionSound_CreateStream( IFusionSound               *thiz,
      if (buffersize > rate * 5)
           return DR_LIMITEXCEEDED;
 
-     ret = fs_buffer_create( data->core, buffersize, mode, format, rate, &buffer );
+     ret = fs_buffer_create( data->core, buffersize, mode, format, rate, true, &buffer );
      if (ret)
           return ret;
 
      DIRECT_ALLOCATE_INTERFACE( iface, IFusionSoundStream );
 
-     ret = IFusionSoundStream_Construct( iface, data->core, buffer, buffersize, mode, format, rate, prebuffer );
+     ret = IFusionSoundStream_Construct( iface, data->core, buffer, buffersize, mode, format, rate, prebuffer, caps,
+                                         callback, ctx );
 
      fs_buffer_unref( buffer );
 
@@ -457,6 +479,170 @@ IFusionSound_GetMasterFeedback( IFusionSound *thiz,
      return fs_core_get_master_feedback( data->core, ret_left, ret_right );
 }
 
+static DirectResult
+IFusionSound_StartBatch( IFusionSound       *thiz,
+                         const FSBatchEntry *entries,
+                         int                 num )
+{
+     DirectResult   ret = DR_OK;
+     CorePlayback **playbacks;
+     int           *positions;
+     int           *stops;
+     int            i, n;
+
+     DIRECT_INTERFACE_GET_DATA( IFusionSound )
+
+     D_DEBUG_AT( FusionSound, "%s( %p, %d )\n", __FUNCTION__, thiz, num );
+
+     /* Check arguments */
+     if (!entries || num < 1)
+          return DR_INVARG;
+
+     for (i = 0; i < num; i++) {
+          if (!entries[i].playback == !entries[i].buffer)
+               return DR_INVARG;
+     }
+
+     playbacks = D_CALLOC( num, sizeof(CorePlayback*) );
+     if (!playbacks)
+          return D_OOM();
+
+     positions = D_CALLOC( num * 2, sizeof(int) );
+     if (!positions) {
+          D_FREE( playbacks );
+          return D_OOM();
+     }
+
+     stops = positions + num;
+
+     /* Check all playbacks before changing anything, their range is set while starting them. */
+     for (i = 0; i < num; i++) {
+          if (entries[i].playback) {
+               ret = IFusionSoundPlayback_PrepareStart( entries[i].playback, entries[i].start, entries[i].stop,
+                                                        &playbacks[i] );
+               if (ret)
+                    goto out;
+
+               positions[i] = entries[i].start;
+               stops[i]     = entries[i].stop;
+          }
+          else
+               positions[i] = -1;
+     }
+
+     /* Set up playbacks of all buffers before starting any of them. */
+     for (n = 0; n < num; n++) {
+          if (entries[n].buffer) {
+               ret = IFusionSoundBuffer_PreparePlayback( entries[n].buffer, entries[n].flags, &playbacks[n] );
+               if (ret)
+                    break;
+          }
+     }
+
+     /* Start them with the playlist locked once. */
+     if (!ret)
+          ret = fs_core_start_playbacks( data->core, playbacks, positions, stops, num );
+
+     /* Hand the playbacks back to the buffers. */
+     for (i = 0; i < n; i++) {
+          if (entries[i].buffer)
+               IFusionSoundBuffer_FinishPlayback( entries[i].buffer, playbacks[i], entries[i].flags, ret );
+     }
+
+out:
+     D_FREE( positions );
+     D_FREE( playbacks );
+
+     return ret;
+}
+
+static DirectResult
+IFusionSound_StopBatch( IFusionSound       *thiz,
+                        const FSBatchEntry *entries,
+                        int                 num )
+{
+     DirectResult   ret = DR_OK;
+     CorePlayback **playbacks;
+     int            i;
+
+     DIRECT_INTERFACE_GET_DATA( IFusionSound )
+
+     D_DEBUG_AT( FusionSound, "%s( %p, %d )\n", __FUNCTION__, thiz, num );
+
+     /* Check arguments */
+     if (!entries || num < 1)
+          return DR_INVARG;
+
+     for (i = 0; i < num; i++) {
+          if (!entries[i].playback == !entries[i].buffer)
+               return DR_INVARG;
+     }
+
+     playbacks = D_CALLOC( num, sizeof(CorePlayback*) );
+     if (!playbacks)
+          return D_OOM();
+
+     /* Collect the playbacks, taking over the looping playbacks of buffers. */
+     for (i = 0; i < num; i++) {
+          if (entries[i].playback)
+               ret = IFusionSoundPlayback_GetPlayback( entries[i].playback, &playbacks[i] );
+          else
+               ret = IFusionSoundBuffer_TakeLoopingPlayback( entries[i].buffer, &playbacks[i] );
+
+          if (ret)
+               break;
+     }
+
+     /* Stop them with the playlist locked once, buffers without a looping playback are skipped. */
+     if (!ret)
+          ret = fs_core_stop_playbacks( data->core, playbacks, num );
+
+     /* Discard the looping playbacks. */
+     for (i = 0; i < num; i++) {
+          if (entries[i].buffer && playbacks[i]) {
+               if (ret)
+                    fs_playback_stop( playbacks[i], false );
+
+               fs_playback_unref( playbacks[i] );
+          }
+     }
+
+     D_FREE( playbacks );
+
+     return ret;
+}
+
+static DirectResult
+IFusionSound_UpdatePlaybacks( IFusionSound           *thiz,
+                              const FSPlaybackUpdate *updates,
+                              int                     num )
+{
+     DirectResult ret;
+     int          i;
+
+     DIRECT_INTERFACE_GET_DATA( IFusionSound )
+
+     D_DEBUG_AT( FusionSound, "%s( %p, %d )\n", __FUNCTION__, thiz, num );
+
+     /* Check arguments */
+     if (!updates || num < 1)
+          return DR_INVARG;
+
+     for (i = 0; i < num; i++) {
+          if (!updates[i].playback)
+               return DR_INVARG;
+     }
+
+     /* Lock each playback once for all of its parameters. */
+     for (i = 0; i < num; i++) {
+          ret = IFusionSoundPlayback_Update( updates[i].playback, &updates[i] );
+          if (ret)
+               return ret;
+     }
+
+     return DR_OK;
+}
+
 DirectResult
 IFusionSound_Construct( IFusionSound *thiz )
 {
@@ -487,6 +673,9 @@ IFusionSound_Construct( IFusionSound *thiz )
      thiz->Suspend              = IFusionSound_Suspend;
      thiz->Resume               = IFusionSound_Resume;
      thiz->GetMasterFeedback    = IFusionSound_GetMasterFeedback;
+     thiz->StartBatch           = IFusionSound_StartBatch;
+     thiz->StopBatch            = IFusionSound_StopBatch;
+     thiz->UpdatePlaybacks      = IFusionSound_UpdatePlaybacks;
 
      return DR_OK;
 }
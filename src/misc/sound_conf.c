@@ -16,6 +16,7 @@
    Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
 */
 
+#include <build.h>
 #include <direct/filesystem.h>
 #include <direct/memcpy.h>
 #include <direct/system.h>
@@ -50,6 +51,9 @@ static const char *fs_config_usage =
      "  samplerate=<samplerate>        Set the default sample rate (default = 48000)\n"
      "  buffertime=<millisec>          Set the default buffer time (default = 25)\n"
      "  [no-]dither                    Enable dithering\n"
+     "  quality=<quality>              Set the default interpolation quality ('none', 'linear', 'cubic' or 'sinc')\n"
+     "  mixthreads=<num>               Set the number of threads mixing playbacks (default = 1)\n"
+     "  [no-]mix-deterministic         Mix playbacks in a fixed order when using multiple threads (default enabled)\n"
      "\n";
 
 /**********************************************************************************************************************/
@@ -138,6 +142,10 @@ config_allocate()
      fs_config->sampleformat   = FSSF_S16;
      fs_config->samplerate     = 48000;
      fs_config->buffertime     = 25;
+     fs_config->quality        = FS_LINEAR_FILTER ? FSPQ_LINEAR : FSPQ_NONE;
+
+     fs_config->mixthreads        = 1;
+     fs_config->mix_deterministic = true;
 }
 
 static DirectResult
@@ -345,6 +353,53 @@ fs_config_set( const char *name,
      } else
      if (strcmp( name, "no-dither" ) == 0) {
           fs_config->dither = false;
+     } else
+     if (strcmp( name, "quality" ) == 0) {
+          if (value) {
+               if (strcmp( value, "none" ) == 0)
+                    fs_config->quality = FSPQ_NONE;
+               else if (strcmp( value, "linear" ) == 0)
+                    fs_config->quality = FSPQ_LINEAR;
+               else if (strcmp( value, "cubic" ) == 0)
+                    fs_config->quality = FSPQ_CUBIC;
+               else if (strcmp( value, "sinc" ) == 0)
+                    fs_config->quality = FSPQ_SINC;
+               else {
+                    D_ERROR( "FusionSound/Config: '%s': Could not parse quality!\n", name );
+                    return DR_INVARG;
+               }
+          }
+          else {
+               D_ERROR( "FusionSound/Config: '%s': No quality specified!\n", name );
+               return DR_INVARG;
+          }
+     } else
+     if (strcmp( name, "mixthreads" ) == 0) {
+          if (value) {
+               int num;
+
+               if (sscanf( value, "%d", &num ) < 1) {
+                    D_ERROR( "FusionSound/Config: '%s': Could not parse value!\n", name );
+                    return DR_INVARG;
+               }
+
+               if (num < 1 || num > 64) {
+                    D_ERROR( "FusionSound/Config: '%s': Unsupported value '%d'!\n", name, num );
+                    return DR_INVARG;
+               }
+
+               fs_config->mixthreads = num;
+          }
+          else {
+               D_ERROR( "FusionSound/Config: '%s': No value specified!\n", name );
+               return DR_INVARG;
+          }
+     } else
+     if (strcmp( name, "mix-deterministic" ) == 0) {
+          fs_config->mix_deterministic = true;
+     } else
+     if (strcmp( name, "no-mix-deterministic" ) == 0) {
+          fs_config->mix_deterministic = false;
      }
      else {
           fsoption = false;
@@ -24,16 +24,19 @@
 /**********************************************************************************************************************/
 
 typedef struct {
-     char           *snddriver;
-     bool            banner;
-     bool            wait;
-     bool            deinit_check;
-     int             session;
-     FSChannelMode   channelmode;
-     FSSampleFormat  sampleformat;
-     int             samplerate;
-     int             buffertime;
-     bool            dither;
+     char              *snddriver;
+     bool               banner;
+     bool               wait;
+     bool               deinit_check;
+     int                session;
+     FSChannelMode      channelmode;
+     FSSampleFormat     sampleformat;
+     int                samplerate;
+     int                buffertime;
+     bool               dither;
+     FSPlaybackQuality  quality;
+     int                mixthreads;
+     bool               mix_deterministic;
 } FSConfig;
 
 /**********************************************************************************************************************/
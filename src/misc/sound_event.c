@@ -0,0 +1,106 @@
+/*
+   This file is part of DirectFB.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#include <config.h>
+#include <direct/util.h>
+#include <misc/sound_event.h>
+#ifdef HAVE_SYS_EVENTFD_H
+#include <sys/eventfd.h>
+#endif
+
+D_DEBUG_DOMAIN( Sound_Event, "Sound/Event", "FusionSound Event" );
+
+/**********************************************************************************************************************/
+
+void
+fs_event_init( FSEvent *event )
+{
+     D_ASSERT( event != NULL );
+
+     event->fd    = -1;
+     event->ready = false;
+}
+
+void
+fs_event_deinit( FSEvent *event )
+{
+     D_ASSERT( event != NULL );
+
+     if (event->fd >= 0) {
+          close( event->fd );
+
+          event->fd = -1;
+     }
+}
+
+DirectResult
+fs_event_create( FSEvent *event,
+                 bool     ready,
+                 int     *ret_fd )
+{
+     D_ASSERT( event != NULL );
+     D_ASSERT( ret_fd != NULL );
+
+     D_DEBUG_AT( Sound_Event, "%s( %p, %sready )\n", __FUNCTION__, event, ready ? "" : "not " );
+
+#ifdef HAVE_SYS_EVENTFD_H
+     if (event->fd < 0) {
+          event->fd = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK );
+          if (event->fd < 0)
+               return errno2result( errno );
+
+          event->ready = false;
+     }
+
+     fs_event_set( event, ready );
+
+     *ret_fd = event->fd;
+
+     return DR_OK;
+#else
+     return DR_UNSUPPORTED;
+#endif
+}
+
+void
+fs_event_set( FSEvent *event,
+              bool     ready )
+{
+     D_ASSERT( event != NULL );
+
+     if (event->fd < 0 || event->ready == ready)
+          return;
+
+     D_DEBUG_AT( Sound_Event, "%s( %p, %sready )\n", __FUNCTION__, event, ready ? "" : "not " );
+
+#ifdef HAVE_SYS_EVENTFD_H
+     if (ready) {
+          /* Set the counter, making the descriptor readable. */
+          if (eventfd_write( event->fd, 1 ))
+               return;
+     }
+     else {
+          eventfd_t value;
+
+          /* Reset the counter, unless already read by the application. */
+          eventfd_read( event->fd, &value );
+     }
+#endif
+
+     event->ready = ready;
+}
@@ -0,0 +1,53 @@
+/*
+   This file is part of DirectFB.
+
+   This library is free software; you can redistribute it and/or
+   modify it under the terms of the GNU Lesser General Public
+   License as published by the Free Software Foundation; either
+   version 2.1 of the License, or (at your option) any later version.
+
+   This library is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+   Lesser General Public License for more details.
+
+   You should have received a copy of the GNU Lesser General Public
+   License along with this library; if not, write to the Free Software
+   Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA
+*/
+
+#ifndef __MISC__SOUND_EVENT_H__
+#define __MISC__SOUND_EVENT_H__
+
+#include <core/coretypes_sound.h>
+
+/**********************************************************************************************************************/
+
+/*
+ * File descriptor which is readable as long as a condition holds.
+ */
+typedef struct {
+     int   fd;    /* -1 until created */
+     bool  ready; /* condition signaled */
+} FSEvent;
+
+/**********************************************************************************************************************/
+
+void         fs_event_init  ( FSEvent *event );
+
+void         fs_event_deinit( FSEvent *event );
+
+/*
+ * Create the file descriptor (if not done yet), with the condition given by 'ready'.
+ */
+DirectResult fs_event_create( FSEvent *event,
+                              bool     ready,
+                              int     *ret_fd );
+
+/*
+ * Make the file descriptor readable or not, without system calls unless the condition changes.
+ */
+void         fs_event_set   ( FSEvent *event,
+                              bool     ready );
+
+#endif
@@ -17,6 +17,7 @@
 */
 
 #include <core/playback.h>
+#include <misc/sound_event.h>
 #include <playback/ifusionsoundplayback.h>
 
 D_DEBUG_DOMAIN( Playback, "IFusionSoundPlayback", "IFusionSoundPlayback Interface" );
@@ -43,6 +44,10 @@ typedef struct {
 
      DirectMutex      lock;
      DirectWaitQueue  wait;
+
+     FSEvent          event;    /* readable while the playback isn't running (or has advanced to the target) */
+     bool             advance;  /* event waits for the playback to advance to the target */
+     unsigned int     target;   /* number of frames played at which the event becomes readable */
 } IFusionSoundPlayback_data;
 
 /**********************************************************************************************************************/
@@ -55,10 +60,14 @@ IFusionSoundPlayback_Destruct( IFusionSoundPlayback *thiz )
      D_DEBUG_AT( Playback, "%s( %p )\n", __FUNCTION__, thiz );
 
      fs_playback_detach( data->playback, &data->reaction );
+     if (data->advance)
+          fs_playback_clear_watermark( data->playback );
      if (!data->stream)
           fs_playback_stop( data->playback, false );
      fs_playback_unref( data->playback );
 
+     fs_event_deinit( &data->event );
+
      direct_waitqueue_deinit( &data->wait );
      direct_mutex_deinit( &data->lock );
 
@@ -95,27 +104,26 @@ IFusionSoundPlayback_Start( IFusionSoundPlayback *thiz,
                             int                   start,
                             int                   stop )
 {
+     DirectResult  ret;
+     CorePlayback *playback;
+
      DIRECT_INTERFACE_GET_DATA( IFusionSoundPlayback )
 
      D_DEBUG_AT( Playback, "%s( %p, %d -> %d )\n", __FUNCTION__, thiz, start, stop );
 
-     if (data->stream)
-          return DR_UNSUPPORTED;
-
-     if (start < 0 || start >= data->length)
-          return DR_INVARG;
-
-     if (stop >= data->length)
-          return DR_INVARG;
+     ret = IFusionSoundPlayback_PrepareStart( thiz, start, stop, &playback );
+     if (ret)
+          return ret;
 
      direct_mutex_lock( &data->lock );
 
-     fs_playback_set_position( data->playback, start );
-     fs_playback_set_stop( data->playback, stop );
-     fs_playback_start( data->playback, false );
+     fs_playback_set_position( playback, start );
+     fs_playback_set_stop( playback, stop );
 
      direct_mutex_unlock( &data->lock );
 
+     fs_playback_start( playback, false );
+
      return DR_OK;
 }
 
@@ -201,11 +209,14 @@ IFusionSoundPlayback_GetStatus( IFusionSoundPlayback *thiz,
      return DR_OK;
 }
 
-static DirectResult
-UpdateVolume( IFusionSoundPlayback_data *data )
+static void
+ComputeLevels( IFusionSoundPlayback_data *data,
+               float                      levels[6] )
 {
-                      /*    L     R     C    Rl    Rr   LFE */
-     float levels[6] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+     int i;
+
+     for (i = 0; i < 6; i++)
+          levels[i] = 1.0f;
 
      if (data->pan != 0.0f) {
           if (data->pan < 0.0f)
@@ -215,13 +226,20 @@ UpdateVolume( IFusionSoundPlayback_data *data )
      }
 
      if (data->volume != 1.0f) {
-          int i;
           for (i = 0; i < 6; i++) {
                levels[i] *= data->volume;
                if (levels[i] > 64.0f)
                     levels[i] = 64.0f;
           }
      }
+}
+
+static DirectResult
+UpdateVolume( IFusionSoundPlayback_data *data )
+{
+     float levels[6];
+
+     ComputeLevels( data, levels );
 
      return fs_playback_set_volume( data->playback, levels );
 }
@@ -328,6 +346,121 @@ IFusionSoundPlayback_SetDownmixLevels( IFusionSoundPlayback *thiz,
      return UpdateVolume( data );
 }
 
+static DirectResult
+IFusionSoundPlayback_SetQuality( IFusionSoundPlayback *thiz,
+                                 FSPlaybackQuality     quality )
+{
+     DIRECT_INTERFACE_GET_DATA( IFusionSoundPlayback )
+
+     D_DEBUG_AT( Playback, "%s( %p, %d )\n", __FUNCTION__, thiz, quality );
+
+     switch (quality) {
+          case FSPQ_NONE:
+          case FSPQ_LINEAR:
+          case FSPQ_CUBIC:
+          case FSPQ_SINC:
+               break;
+          default:
+               return DR_INVARG;
+     }
+
+     return fs_playback_set_quality( data->playback, quality );
+}
+
+/*
+ * Check whether the event is to be readable, the interface being locked.
+ */
+static bool
+EventReady( IFusionSoundPlayback_data *data )
+{
+     CorePlaybackStatus status;
+     unsigned int       played;
+
+     /* Use the current status, a notification may arrive after the playback has been restarted or stopped. */
+     fs_playback_get_status( data->playback, &status, NULL );
+
+     if (!(status & CPS_PLAYING))
+          return true;
+
+     if (!data->advance)
+          return false;
+
+     fs_playback_get_played( data->playback, &played, NULL );
+
+     if ((int) (played - data->target) < 0)
+          return false;
+
+     /* Stop notifications once the target has been reached. */
+     fs_playback_clear_watermark( data->playback );
+
+     return true;
+}
+
+static DirectResult
+IFusionSoundPlayback_CreateFileDescriptor( IFusionSoundPlayback *thiz,
+                                           int                  *ret_fd )
+{
+     DirectResult ret;
+
+     DIRECT_INTERFACE_GET_DATA( IFusionSoundPlayback )
+
+     D_DEBUG_AT( Playback, "%s( %p )\n", __FUNCTION__, thiz );
+
+     if (!ret_fd)
+          return DR_INVARG;
+
+     direct_mutex_lock( &data->lock );
+
+     if (data->advance) {
+          data->advance = false;
+
+          fs_playback_clear_watermark( data->playback );
+     }
+
+     ret = fs_event_create( &data->event, EventReady( data ), ret_fd );
+
+     direct_mutex_unlock( &data->lock );
+
+     return ret;
+}
+
+static DirectResult
+IFusionSoundPlayback_CreateAdvanceDescriptor( IFusionSoundPlayback *thiz,
+                                              int                   length,
+                                              int                  *ret_fd )
+{
+     DirectResult ret;
+     unsigned int played;
+
+     DIRECT_INTERFACE_GET_DATA( IFusionSoundPlayback )
+
+     D_DEBUG_AT( Playback, "%s( %p, %d )\n", __FUNCTION__, thiz, length );
+
+     if (length < 1 || !ret_fd)
+          return DR_INVARG;
+
+     /* The watermark of a stream's playback is used by the stream. */
+     if (data->stream)
+          return DR_UNSUPPORTED;
+
+     direct_mutex_lock( &data->lock );
+
+     ret = fs_playback_get_played( data->playback, &played, NULL );
+     if (ret == DR_OK) {
+          data->advance = true;
+          data->target  = played + length;
+
+          /* Get notified when the target is reached, it may have been reached before arming the watermark. */
+          fs_playback_set_watermark( data->playback, data->target );
+
+          ret = fs_event_create( &data->event, EventReady( data ), ret_fd );
+     }
+
+     direct_mutex_unlock( &data->lock );
+
+     return ret;
+}
+
 static ReactionResult
 IFusionSoundPlayback_React( const void *msg_data,
                             void       *ctx )
@@ -346,8 +479,15 @@ IFusionSoundPlayback_React( const void *msg_data,
      if (notification->flags & CPNF_ADVANCE)
           D_DEBUG_AT( Playback, "  -> playback advanced to position %d\n", notification->pos );
 
-     if (notification->flags & (CPNF_START | CPNF_STOP))
+     direct_mutex_lock( &data->lock );
+
+     if ((notification->flags & (CPNF_START | CPNF_STOP)) || data->advance) {
+          fs_event_set( &data->event, EventReady( data ) );
+
           direct_waitqueue_broadcast( &data->wait );
+     }
+
+     direct_mutex_unlock( &data->lock );
 
      return RS_OK;
 }
@@ -388,18 +528,125 @@ IFusionSoundPlayback_Construct( IFusionSoundPlayback *thiz,
      direct_recursive_mutex_init( &data->lock );
      direct_waitqueue_init( &data->wait );
 
-     thiz->AddRef           = IFusionSoundPlayback_AddRef;
-     thiz->Release          = IFusionSoundPlayback_Release;
-     thiz->Start            = IFusionSoundPlayback_Start;
-     thiz->Stop             = IFusionSoundPlayback_Stop;
-     thiz->Continue         = IFusionSoundPlayback_Continue;
-     thiz->Wait             = IFusionSoundPlayback_Wait;
-     thiz->GetStatus        = IFusionSoundPlayback_GetStatus;
-     thiz->SetVolume        = IFusionSoundPlayback_SetVolume;
-     thiz->SetPan           = IFusionSoundPlayback_SetPan;
-     thiz->SetPitch         = IFusionSoundPlayback_SetPitch;
-     thiz->SetDirection     = IFusionSoundPlayback_SetDirection;
-     thiz->SetDownmixLevels = IFusionSoundPlayback_SetDownmixLevels;
+     fs_event_init( &data->event );
+
+     thiz->AddRef                  = IFusionSoundPlayback_AddRef;
+     thiz->Release                 = IFusionSoundPlayback_Release;
+     thiz->Start                   = IFusionSoundPlayback_Start;
+     thiz->Stop                    = IFusionSoundPlayback_Stop;
+     thiz->Continue                = IFusionSoundPlayback_Continue;
+     thiz->Wait                    = IFusionSoundPlayback_Wait;
+     thiz->GetStatus               = IFusionSoundPlayback_GetStatus;
+     thiz->SetVolume               = IFusionSoundPlayback_SetVolume;
+     thiz->SetPan                  = IFusionSoundPlayback_SetPan;
+     thiz->SetPitch                = IFusionSoundPlayback_SetPitch;
+     thiz->SetDirection            = IFusionSoundPlayback_SetDirection;
+     thiz->SetDownmixLevels        = IFusionSoundPlayback_SetDownmixLevels;
+     thiz->SetQuality              = IFusionSoundPlayback_SetQuality;
+     thiz->CreateFileDescriptor    = IFusionSoundPlayback_CreateFileDescriptor;
+     thiz->CreateAdvanceDescriptor = IFusionSoundPlayback_CreateAdvanceDescriptor;
+
+     return DR_OK;
+}
+
+DirectResult
+IFusionSoundPlayback_PrepareStart( IFusionSoundPlayback  *thiz,
+                                   int                    start,
+                                   int                    stop,
+                                   CorePlayback         **ret_playback )
+{
+     DIRECT_INTERFACE_GET_DATA( IFusionSoundPlayback )
+
+     D_DEBUG_AT( Playback, "%s( %p, %d -> %d )\n", __FUNCTION__, thiz, start, stop );
+
+     D_ASSERT( ret_playback != NULL );
+
+     if (data->stream)
+          return DR_UNSUPPORTED;
+
+     if (start < 0 || start >= data->length)
+          return DR_INVARG;
+
+     if (stop >= data->length)
+          return DR_INVARG;
+
+     *ret_playback = data->playback;
+
+     return DR_OK;
+}
+
+DirectResult
+IFusionSoundPlayback_GetPlayback( IFusionSoundPlayback  *thiz,
+                                  CorePlayback         **ret_playback )
+{
+     DIRECT_INTERFACE_GET_DATA( IFusionSoundPlayback )
+
+     D_DEBUG_AT( Playback, "%s( %p )\n", __FUNCTION__, thiz );
+
+     D_ASSERT( ret_playback != NULL );
+
+     *ret_playback = data->playback;
 
      return DR_OK;
 }
+
+DirectResult
+IFusionSoundPlayback_Update( IFusionSoundPlayback   *thiz,
+                             const FSPlaybackUpdate *update )
+{
+     float levels[6];
+
+     DIRECT_INTERFACE_GET_DATA( IFusionSoundPlayback )
+
+     D_DEBUG_AT( Playback, "%s( %p )\n", __FUNCTION__, thiz );
+
+     D_ASSERT( update != NULL );
+
+     if (update->flags & ~FSPUF_ALL)
+          return DR_INVARG;
+
+     if (update->flags & FSPUF_VOLUME) {
+          if (update->volume < 0.0f)
+               return DR_INVARG;
+
+          if (update->volume > 64.0f)
+               return DR_UNSUPPORTED;
+     }
+
+     if (update->flags & FSPUF_PAN) {
+          if (update->pan < -1.0f || update->pan > 1.0f)
+               return DR_INVARG;
+     }
+
+     if (update->flags & FSPUF_PITCH) {
+          if (update->pitch < 0.0f)
+               return DR_INVARG;
+
+          if (update->pitch > 64.0f)
+               return DR_UNSUPPORTED;
+     }
+
+     if (update->flags & FSPUF_VOLUME)
+          data->volume = update->volume;
+
+     if (update->flags & FSPUF_PAN)
+          data->pan = update->pan;
+
+     if (update->flags & FSPUF_PITCH)
+          data->pitch = update->pitch * FS_PITCH_ONE + 0.5f;
+
+     /* Only queue the parameters that have been updated. */
+     if (!(update->flags & (FSPUF_VOLUME | FSPUF_PAN))) {
+          if (!(update->flags & FSPUF_PITCH))
+               return DR_OK;
+
+          return fs_playback_set_pitch( data->playback, data->pitch * data->dir );
+     }
+
+     ComputeLevels( data, levels );
+
+     if (!(update->flags & FSPUF_PITCH))
+          return fs_playback_set_volume( data->playback, levels );
+
+     return fs_playback_set_params( data->playback, levels, data->pitch * data->dir );
+}
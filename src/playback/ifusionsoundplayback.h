@@ -28,4 +28,26 @@ DirectResult IFusionSoundPlayback_Construct( IFusionSoundPlayback *thiz,
                                              CorePlayback         *playback,
                                              int                   length );
 
+/*
+ * Check the start and stop position of the playback for IFusionSound::StartBatch() without changing anything and
+ * return the playback object, which is referenced by the interface.
+ */
+DirectResult IFusionSoundPlayback_PrepareStart( IFusionSoundPlayback  *thiz,
+                                                int                    start,
+                                                int                    stop,
+                                                CorePlayback         **ret_playback );
+
+/*
+ * Return the playback object, which is referenced by the interface.
+ */
+DirectResult IFusionSoundPlayback_GetPlayback ( IFusionSoundPlayback  *thiz,
+                                                CorePlayback         **ret_playback );
+
+/*
+ * Set volume, panning and pitch of the playback at once for IFusionSound::UpdatePlaybacks(), only the parameters given
+ * by the flags are changed.
+ */
+DirectResult IFusionSoundPlayback_Update      ( IFusionSoundPlayback   *thiz,
+                                                const FSPlaybackUpdate *update );
+
 #endif